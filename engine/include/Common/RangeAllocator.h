@@ -0,0 +1,74 @@
+//
+// Created by pointerlost on 1/12/26.
+//
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace Real {
+
+    // First fit free list over [0, capacity), freed ranges are merged with their neighbours
+    // Doesn't own any memory, it only hands out offsets (used for the GPU pools)
+    class RangeAllocator {
+    public:
+        RangeAllocator() = default;
+        explicit RangeAllocator(uint64_t capacity) { Grow(capacity); }
+
+        std::optional<uint64_t> Allocate(uint64_t count) {
+            if (count == 0) return std::nullopt;
+
+            for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it) {
+                const auto [offset, size] = *it;
+                if (size < count) continue;
+
+                m_FreeRanges.erase(it);
+                if (size > count)
+                    m_FreeRanges.emplace(offset + count, size - count);
+                m_Used += count;
+                return offset;
+            }
+            return std::nullopt;
+        }
+
+        void Free(uint64_t offset, uint64_t count) {
+            if (count == 0) return;
+            m_Used -= count;
+
+            auto next = m_FreeRanges.lower_bound(offset);
+            // Merge with the previous range
+            if (next != m_FreeRanges.begin()) {
+                auto prev = std::prev(next);
+                if (prev->first + prev->second == offset) {
+                    offset = prev->first;
+                    count += prev->second;
+                    m_FreeRanges.erase(prev);
+                }
+            }
+            // Merge with the next range
+            if (next != m_FreeRanges.end() && offset + count == next->first) {
+                count += next->second;
+                m_FreeRanges.erase(next);
+            }
+            m_FreeRanges.emplace(offset, count);
+        }
+
+        // New space is appended as a free range
+        void Grow(uint64_t newCapacity) {
+            if (newCapacity <= m_Capacity) return;
+            const uint64_t oldCapacity = m_Capacity;
+            m_Capacity = newCapacity;
+            m_Used += newCapacity - oldCapacity; // Free() takes it back
+            Free(oldCapacity, newCapacity - oldCapacity);
+        }
+
+        [[nodiscard]] uint64_t GetCapacity() const { return m_Capacity; }
+        [[nodiscard]] uint64_t GetUsed() const { return m_Used; }
+
+    private:
+        std::map<uint64_t, uint64_t> m_FreeRanges; // offset -> count
+        uint64_t m_Capacity = 0;
+        uint64_t m_Used = 0;
+    };
+}
@@ -2,6 +2,7 @@
 // Created by pointerlost on 12/4/25.
 //
 #pragma once
+#include <cstdint>
 
 namespace Real {
 
@@ -35,6 +36,18 @@ namespace Real {
         real_null,
     };
 
+    // Vertex layout of the mesh binaries, the GPU pool always holds the compact one
+    enum class VertexFormat : uint32_t {
+        FLOAT32, // Vertex, 32 bytes
+        COMPACT, // PackedVertex, 16 bytes
+    };
+
+    // Payload (vertices + indices) of the mesh binaries
+    enum class MeshCompression : uint32_t {
+        NONE,
+        ZSTD, // One frame, small meshes use the mesh dictionary
+    };
+
     enum class TextureFilterMode {
         NEAREST,
         LINEAR,
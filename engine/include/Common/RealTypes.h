@@ -4,10 +4,13 @@
 #pragma once
 #include <glm/ext.hpp>
 #include "Macros.h"
+#include "RealEnum.h"
 #include <vector>
 #include <Core/UUID.h>
+#include "Common/SlotMap.h"
 
 namespace Real {
+    struct MaterialInstance;
 
     struct Vertex {
         glm::vec3 m_Position;
@@ -15,6 +18,15 @@ namespace Real {
         glm::vec2 m_UV;
     };
 
+    // Universal VBO layout, half the size of Vertex
+    struct PackedVertex {
+        uint16_t m_Position[3]; // unorm16 inside the mesh bounds
+        uint16_t m_Tangent;     // Reserved for an octahedral snorm8x2 tangent, zero for now
+        uint32_t m_Normal;      // Octahedral snorm16x2
+        uint32_t m_UV;          // half2
+    };
+    static_assert(sizeof(PackedVertex) == 16);
+
     struct TextureData {
         void* m_Data = nullptr;
         int m_ChannelCount = 0;
@@ -25,6 +37,25 @@ namespace Real {
         int m_InternalFormat = {};
     };
 
+    // Object space bounds, the bounding sphere is derived from it (center + half diagonal)
+    struct AABB {
+        glm::vec3 m_Min{0.0f};
+        glm::vec3 m_Max{0.0f};
+
+        [[nodiscard]] glm::vec3 GetCenter() const { return (m_Min + m_Max) * 0.5f; }
+        [[nodiscard]] float GetRadius() const { return glm::length(m_Max - m_Min) * 0.5f; }
+    };
+
+    // Contiguous triangle range of a mesh, culled on its own (bounding sphere + normal cone)
+    struct Meshlet {
+        uint32_t m_IndexOffset = 0; // Relative to the first index of the mesh
+        uint32_t m_IndexCount = 0;
+        glm::vec3 m_Center{0.0f};
+        float m_Radius = 0.0f;
+        glm::vec3 m_ConeAxis{0.0f, 0.0f, 1.0f};
+        float m_ConeCutoff = 1.0f; // sin of the normal spread, 1 = never backface culled
+    };
+
     struct FileInfo {
         std::string name; // Full name
         std::string stem; // Name without extension
@@ -40,9 +71,14 @@ namespace Real {
         uint64_t m_UUID{};
     };
 
+    // Version 2 appends the bounds, version 1 files are still readable (bounds computed on load)
+    // Version 3 appends the vertex format, older files are FLOAT32
+    // Version 4 appends the payload compression, older files are raw
+    constexpr uint32_t MESH_BINARY_VERSION = 4;
+
     struct MeshBinaryHeader {
         uint32_t m_Magic = REAL_MAGIC;
-        uint32_t m_Version = 1;
+        uint32_t m_Version = MESH_BINARY_VERSION;
 
         uint64_t m_UUID{};
         uint64_t m_MaterialUUID{};
@@ -51,12 +87,32 @@ namespace Real {
         uint64_t m_IndexCount{};
         uint64_t m_VertexOffset{};
         uint64_t m_IndexOffset{};
+
+        // Version 2
+        float m_BoundsMin[3]{};
+        float m_BoundsMax[3]{};
+
+        // Version 3
+        VertexFormat m_VertexFormat = VertexFormat::FLOAT32;
+
+        // Version 4
+        MeshCompression m_Compression = MeshCompression::NONE;
+        uint64_t m_PayloadSize{}; // Bytes after the header (compressed size)
+    };
+
+    // Written next to the mesh binary (<uuid>.meshlets), only dense meshes have one
+    struct MeshletBinaryHeader {
+        uint32_t m_Magic = REAL_MAGIC;
+        uint32_t m_Version = 1;
+        uint64_t m_MeshUUID{};
+        uint64_t m_MeshletCount{};
     };
 #pragma pack(pop)
 
     struct MeshLoadResult {
         MeshBinaryHeader header;
-        std::vector<Vertex> vertices;
+        std::vector<Vertex> vertices; // FLOAT32 binaries
+        std::vector<PackedVertex> packedVertices; // COMPACT binaries
         std::vector<uint32_t> indices;
     };
 
@@ -68,11 +124,16 @@ namespace Real {
         uint64_t m_IndexCount;
         uint64_t m_VertexOffset;
         uint64_t m_IndexOffset;
+
+        AABB m_Bounds{};
     };
 
+    using MeshHandle = Handle<MeshAsset>;
+    using MaterialHandle = Handle<MaterialInstance>;
+
     struct RenderableData {
-        const MeshAsset* m_Mesh;
-        UUID m_MaterialUUID{};
+        MeshHandle m_Mesh{};
+        MaterialHandle m_Material{};
         // TODO: Need transform for per mesh!
     };
 
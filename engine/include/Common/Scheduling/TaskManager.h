@@ -2,13 +2,94 @@
 // Created by pointerlost on 11/11/25.
 //
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Core/Utils.h"
 
 namespace Real {
 
+    using Job = std::function<void()>;
+
+    // Counts the jobs which are still in flight, a handle is done when the counter drops to zero
+    struct JobCounter {
+        std::atomic<int> m_Pending{0};
+        std::atomic<bool> m_Done{false};
+
+        // Jobs waiting for this counter (dependencies)
+        std::mutex m_Mutex;
+        std::vector<Job> m_Continuations;
+
+        // First exception thrown by one of the jobs, rethrown on the waiting thread
+        // The jobs which didn't start yet are skipped after a failure
+        std::atomic<bool> m_Failed{false};
+        std::exception_ptr m_Exception;
+    };
+    using JobHandle = Ref<JobCounter>;
+
+    // Fixed size worker pool, every worker owns a deque and steals from the others when it runs dry
     class TaskManager {
     public:
-        TaskManager();
+        // 0 = pick the worker count from the hardware (main thread is not counted)
+        explicit TaskManager(uint32_t workerCount = 0);
+        ~TaskManager();
+
+        TaskManager(const TaskManager&) = delete;
+        TaskManager& operator=(const TaskManager&) = delete;
+
+        JobHandle Submit(Job job);
+        // The job will not start before all the dependencies are done
+        JobHandle Submit(Job job, const JobHandle& dependency);
+        JobHandle Submit(Job job, const std::vector<JobHandle>& dependencies);
+
+        // Block until the handle is done, the caller executes pending jobs meanwhile
+        // Rethrows the first exception of the job (or one of its dependencies)
+        void Wait(const JobHandle& handle);
+        void WaitAll(const std::vector<JobHandle>& handles);
+        [[nodiscard]] static bool IsDone(const JobHandle& handle);
+
+        // Split [0, count) into chunks and run them on every core, returns after all the chunks are done
+        // grainSize = 0 picks the chunk size from the worker count, rethrows the first exception of the chunks
+        void ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& func, size_t grainSize = 0);
+
+        [[nodiscard]] uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+        [[nodiscard]] static bool IsWorkerThread();
+
+    private:
+        struct JobEntry {
+            Job m_Job;
+            JobHandle m_Counter;
+        };
+
+        struct WorkerQueue {
+            std::mutex m_Mutex;
+            std::deque<JobEntry> m_Jobs;
+        };
+
+        std::vector<std::thread> m_Workers;
+        std::vector<Scope<WorkerQueue>> m_Queues;
+        std::atomic<bool> m_Running{true};
+        std::atomic<int> m_QueuedJobs{0};
+        std::atomic<uint32_t> m_NextQueue{0};
 
+        std::mutex m_SleepMutex;
+        std::condition_variable m_SleepCV;
 
+    private:
+        void WorkerLoop(uint32_t workerIndex);
+        void Push(JobEntry entry);
+        bool TryPop(JobEntry& out);
+        bool RunOneJob();
+        void Execute(JobEntry& entry);
+        void Complete(const JobHandle& counter);
+        static void Fail(const JobHandle& counter, std::exception_ptr exception);
+        void AddContinuation(const JobHandle& dependency, Job continuation);
+        void WakeSleepers(bool all);
     };
-}
\ No newline at end of file
+}
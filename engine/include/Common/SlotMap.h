@@ -0,0 +1,89 @@
+//
+// Created by pointerlost on 1/10/26.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Real {
+
+    // Index + generation, a handle of a removed element never resolves again even if its slot is reused
+    template <typename T>
+    struct Handle {
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        uint32_t m_Index = INVALID_INDEX;
+        uint32_t m_Generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return m_Index != INVALID_INDEX; }
+        bool operator==(const Handle&) const = default;
+    };
+
+    // Dense storage addressed by handles, lookups are plain array indexing
+    // Elements live in a vector, don't keep pointers across Insert calls!
+    // Tag is the handle type, SlotMap<Ref<X>, X> hands out Handle<X> like a SlotMap<X> would
+    template <typename T, typename Tag = T>
+    class SlotMap {
+    public:
+        Handle<Tag> Insert(T value) {
+            uint32_t index;
+            if (!m_FreeList.empty()) {
+                index = m_FreeList.back();
+                m_FreeList.pop_back();
+                m_Slots[index].m_Value = std::move(value);
+            } else {
+                index = static_cast<uint32_t>(m_Slots.size());
+                m_Slots.push_back({ std::move(value), 0, false });
+            }
+
+            auto& slot = m_Slots[index];
+            slot.m_Alive = true;
+            m_Size++;
+            return { index, slot.m_Generation };
+        }
+
+        bool Remove(const Handle<Tag>& handle) {
+            if (!Contains(handle)) return false;
+
+            auto& slot = m_Slots[handle.m_Index];
+            slot.m_Value = T{};
+            slot.m_Alive = false;
+            slot.m_Generation++; // Old handles are stale from now on
+            m_FreeList.push_back(handle.m_Index);
+            m_Size--;
+            return true;
+        }
+
+        [[nodiscard]] bool Contains(const Handle<Tag>& handle) const {
+            return handle.m_Index < m_Slots.size()
+                && m_Slots[handle.m_Index].m_Alive
+                && m_Slots[handle.m_Index].m_Generation == handle.m_Generation;
+        }
+
+        [[nodiscard]] T* Get(const Handle<Tag>& handle) {
+            return Contains(handle) ? &m_Slots[handle.m_Index].m_Value : nullptr;
+        }
+
+        [[nodiscard]] const T* Get(const Handle<Tag>& handle) const {
+            return Contains(handle) ? &m_Slots[handle.m_Index].m_Value : nullptr;
+        }
+
+        [[nodiscard]] size_t Size() const { return m_Size; }
+        // Upper bound of the handle indices, useful to size the side tables
+        [[nodiscard]] size_t Capacity() const { return m_Slots.size(); }
+
+    private:
+        struct Slot {
+            T m_Value;
+            uint32_t m_Generation;
+            bool m_Alive;
+        };
+
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_FreeList;
+        size_t m_Size = 0;
+    };
+}
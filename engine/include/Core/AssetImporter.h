@@ -3,9 +3,15 @@
 //
 #pragma once
 #include <Core/CMakeConfig.h>
+#include <unordered_set>
 #include <nlohmann/json.hpp>
 #include "Utils.h"
 #include "UUID.h"
+#include "Common/RealEnum.h"
+#include "Common/RealTypes.h"
+#include "Common/Scheduling/TaskManager.h"
+#include "Serialization/AssetPak.h"
+#include "Serialization/AssetRegistry.h"
 
 namespace Real {
     struct MeshBinaryHeader;
@@ -20,15 +26,22 @@ namespace Real {
     class AssetImporter {
     public:
         AssetImporter();
+        // Folds the journal into the JSON, the next startup maps the registry directly
+        ~AssetImporter();
 
+        // Parses the JSON on the first call, the startup only reads the compiled registry
         [[maybe_unused]] nlohmann::json& GetAssetDB();
         void SaveTextureToAssetDB(const OpenGLTexture* texture);
         void SaveMaterialToAssetDB(const Ref<Material>& mat);
-        void SaveModelToAssetDB(const Ref<Model>& model);
+        // sourceHash is the content hash of the model file (see ModelLoader::HashSource), 0 if unknown
+        void SaveModelToAssetDB(const Ref<Model>& model, uint64_t sourceHash = 0);
         void SaveMeshToAssetDB(const MeshBinaryHeader &header, const std::string& name);
 
         void ImportFromDatabase();
 
+        // JSON merge patch (RFC 7396) of the DB, appended to the journal instead of rewriting the whole file
+        void PatchAssetDB(const nlohmann::json& patch);
+        // The DB was edited through GetAssetDB(), the next update writes a full snapshot
         void MarkDirtyAssetDB();
         void UpdateAssetDB();
         void UpdateTextureInAssetDB(const OpenGLTexture* texture);
@@ -40,22 +53,130 @@ namespace Real {
         bool HasAssetWithName(const std::string& sourceName) const;
         bool HasAssetWithPath(const std::string& sourcePath) const;
 
+        // Decode the DB textures on the worker threads
+        void SetParallelImport(bool enable) { m_ParallelImport = enable; }
+
+        // Main thread only, textures are compressed all together when the queue flushed
+        void QueueCompression(const Ref<OpenGLTexture>& texture, bool updateAssetDB = false);
+        void FlushCompressionQueue();
+
+        // Import settings of a texture (version, type), stored next to the source hash
+        [[nodiscard]] static uint64_t HashTextureSettings(TextureType type);
+        // XXH64 of the source file seeded with HashTextureSettings, 0 if it can't be read
+        [[nodiscard]] static uint64_t HashTextureSource(const std::string& path, TextureType type);
+        // Model files of a new folder which were already imported somewhere else (renamed or copied folder),
+        // true if every one of them is reused, nothing is imported again then
+        bool ReuseCookedModels(const std::string& name, const std::vector<std::string>& sourcePaths,
+            const std::vector<uint64_t>& sourceHashes);
+
+    private:
+        // One texture in the DB, filled by the workers
+        struct TextureImportEntry {
+            UUID m_UUID{0};
+            TextureType m_Type = TextureType::UNDEFINED;
+            ImageFormatState m_State = ImageFormatState::UNDEFINED;
+            FileInfo m_Info{};
+            std::string m_SourcePath; // Compressed ones, the file they were cooked from
+            uint64_t m_SourceHash = 0;
+            uint64_t m_SourceStamp = 0;
+            uint64_t m_SourceSettings = 0;
+            bool m_Touched = false;   // Write time (or the settings key of an older import) changed but the content is the same
+            bool m_Stale = false;     // Source changed after the cooking
+            Ref<OpenGLTexture> m_Texture;
+            double m_DecodeMs = 0.0;
+        };
+
+        struct PendingCompression {
+            Ref<OpenGLTexture> m_Texture;
+            bool m_UpdateAssetDB = false;
+            // Filled by the workers before the compression
+            std::string m_SourcePath;
+            uint64_t m_SourceHash = 0;
+            uint64_t m_SourceStamp = 0;
+            uint64_t m_SourceSettings = 0;
+            bool m_Reused = false;
+        };
+
+        struct TextureSource {
+            std::string m_Path;
+            uint64_t m_Hash = 0;
+            uint64_t m_Stamp = 0;
+            uint64_t m_Settings = 0;
+        };
+
+        // Snapshot of the DB written on a worker, the journal before m_JournalSize is in it
+        struct Compaction {
+            JobHandle m_Job;
+            nlohmann::json m_Snapshot;
+            uint64_t m_JournalSize = 0;
+            std::vector<uint8_t> m_Registry;
+            serialization::AssetRegistry::SourceStamp m_Source;
+            bool m_Saved = false;
+        };
+
+        // Mesh pak packed again on a worker, the previous one stays mapped until it's replaced
+        struct PakBuild {
+            JobHandle m_Job;
+            Scope<serialization::AssetPak> m_Previous;
+            std::vector<serialization::PakMeshSource> m_Meshes;
+        };
+
     private:
         static constexpr auto ASSET_DB_PATH = ASSETS_DIR "asset_database/asset_database.json";
+        static constexpr auto ASSET_REGISTRY_PATH = ASSETS_DIR "asset_database/asset_database.bin";
+        // One merge patch per line, replayed over the JSON when it's loaded
+        static constexpr auto ASSET_JOURNAL_PATH = ASSETS_DIR "asset_database/asset_database.journal";
+        // Every mesh binary of the DB in one mapped file, the loose .mesh files stay the source of it
+        static constexpr auto MESH_PAK_PATH = ASSETS_DIR "runtime/meshes.pak";
         nlohmann::json m_AssetDB{};
+        serialization::AssetRegistry m_Registry;
+        bool m_AssetDBLoaded = false;
         bool m_AssetDBDirty  = false;
+        std::string m_PendingJournal; // Patches of this frame, appended on the next update
+        uint64_t m_JournalSize = 0;   // Bytes on disk
+        Scope<Compaction> m_Compaction;
+        Scope<PakBuild> m_PakBuild;
+        bool m_ParallelImport = true;
+        std::vector<PendingCompression> m_CompressionQueue;
 
+        // The registry has the assets of the DB, these only keep the ones added since it was compiled
         // Cache paths with UUIDs to check when new assets are added (Textures, models etc.)
         std::unordered_map<std::string, UUID> m_PathToUUID;
         // Cache paths with UUIDs to check when new assets are added (Materials, meshes etc.)
         std::unordered_map<std::string, UUID> m_NameToUUID;
 
+        // Content hashes, the registry has the ones of the DB
+        std::unordered_map<UUID, TextureSource> m_TextureSources;  // Written with the texture entries
+        std::unordered_set<std::string> m_CookedSourcePaths;       // Normalized, their textures are in the DB already
+        std::unordered_map<uint64_t, std::string> m_CookedTextures; // Source hash -> .dds of this session
+        std::unordered_map<uint64_t, UUID> m_CookedModels;          // Source hash -> model of this session
+        // Dropped from the DB because their sources changed, the loaders import them again
+        std::unordered_set<UUID> m_DroppedAssets;
+        std::unordered_set<std::string> m_DroppedPaths;
+
     private:
         void ImportTextures();
         void ImportMeshes();
         void ImportModels();
         void ImportMaterials();
-        void BuildCachesFromDB();
+        // Models whose files changed are dropped with their meshes before the import
+        void DropStaleModels();
+        // Waits for the packing job
+        void FinishPakBuild();
+        void AddTextureSource(nlohmann::json& tex, const UUID& uuid) const;
+        [[nodiscard]] std::string FindCookedTexture(uint64_t sourceHash) const;
+        [[nodiscard]] UUID FindCookedModel(uint64_t sourceHash) const;
+        void LoadAssetDB();
+        // Recompiles the registry if the JSON changed since the last time
+        void OpenRegistry();
+
+        void AppendJournal();
+        void ReplayJournal();
+        // Drops the records which are already in the snapshot
+        void TrimJournal(uint64_t size);
+        // wait = false writes the snapshot on a worker, it's picked up by a later update
+        void CompactAssetDB(bool wait);
+        void FinishCompaction(bool wait);
 
         void CacheAssetWithName(const std::string& name, const UUID& uuid);
         void CacheAssetWithPath(const std::string& path, const UUID& uuid);
@@ -7,6 +7,8 @@
 #include <vector>
 #include <nlohmann/json.hpp>
 #include "UUID.h"
+#include "Common/RealTypes.h"
+#include "Common/SlotMap.h"
 #include "Graphics/Shader.h"
 #include "Graphics/Texture.h"
 
@@ -43,11 +45,16 @@ namespace Real {
         [[nodiscard]] UUID CreateMaterialInstance(const std::string& assetName);
         [[nodiscard]] UUID GetMaterialAssetUUIDByName(const std::string& assetName);
         [[nodiscard]] Ref<MaterialInstance> GetMaterialInstance(const UUID& instanceUUID);
+        // Per frame code should resolve the UUID once and keep the handle
+        [[nodiscard]] MaterialHandle GetMaterialInstanceHandle(const UUID& instanceUUID) const;
+        [[nodiscard]] Ref<MaterialInstance> GetMaterialInstance(const MaterialHandle& handle) const;
 
         /* *********************************** GENERAL STATE ************************************ */
         [[nodiscard]] const Shader &GetShader(const std::string& name);
         bool IsModelExist(const std::string& name);
         Ref<Model> GetModel(const std::string& name);
+        Ref<Model> GetModel(const UUID& uuid);
+        void RenameModel(const std::string& newName, const UUID& uuid); // Run-time only, the DB is patched by the AssetImporter
         bool IsMaterialExist(const std::string& name);
         void RenameMaterial(const std::string& newName, const UUID& uuid); // Persistent renaming should inside AssetImporter
         void SaveModelCPU(const Ref<Model>& model);
@@ -62,6 +69,7 @@ namespace Real {
         /* ********************************** LOADING STATE ************************************ */
         void Update();
         void LoadShader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& name);
+        void LoadComputeShader(const std::string& computePath, const std::string& name);
         [[nodiscard]] std::vector<GLuint64> UploadTexturesToGPU();
 
     private:
@@ -69,7 +77,8 @@ namespace Real {
         std::unordered_map<UUID, Ref<OpenGLTexture>> m_Textures;
         std::unordered_map<UUID, Ref<Material>> m_Materials;
         std::unordered_map<std::string, UUID> m_MaterialNameToUUID;
-        std::unordered_map<UUID, Ref<MaterialInstance>> m_MaterialInstances;
+        SlotMap<Ref<MaterialInstance>, MaterialInstance> m_MaterialInstances;
+        std::unordered_map<UUID, MaterialHandle> m_MaterialInstanceHandles; // Persistence only
         std::unordered_map<UUID, Ref<Model>> m_Models;
         std::unordered_map<std::string, UUID> m_ModelNameToUUID;
         std::unordered_map<TextureType, Ref<OpenGLTexture>> m_DefaultTextures;
@@ -17,6 +17,7 @@
 #include "Input/CameraInput.h"
 #include "Resource/ResourceLoader.h"
 #include "Core/AssetImporter.h"
+#include "Common/Scheduling/TaskManager.h"
 #include "Scene/Scene.h"
 #include "Scene/Systems.h"
 
@@ -47,6 +48,7 @@ namespace Real {
         Scope<Systems> m_Systems;
         Scope<ResourceLoader> m_ResourceLoader;
         Scope<AssetImporter> m_AssetImporter;
+        Scope<TaskManager> m_TaskManager;
 
         // Scope<Timer> m_GameTimer;
     private:
@@ -55,11 +57,13 @@ namespace Real {
         void StartPhase() const;
         void UpdatePhase() const;
         void RenderPhase() const;
+        void PipelinedPhase() const;
         void EndPhase(GLFWwindow* window);
 
         void InitWindow();
         void InitServices() const;
         void InitSystems();
+        void InitTaskManager();
         void InitAssetImporter();
         void InitEditorState();
         void InitEditorScene();
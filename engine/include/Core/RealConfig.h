@@ -8,3 +8,56 @@ constexpr float SCREEN_HEIGHT = 840.0f;
 
 constexpr int MAX_ENTITIES = 16384;
 constexpr int MAX_LIGHTS = 512;
+
+// Views bigger than this are split into chunks across the workers
+constexpr int SYSTEM_PARALLEL_CHUNK_SIZE = 2048;
+
+// Regions of the ring buffered SSBOs, the CPU writes one while the GPU may still read the others
+constexpr int GPU_FRAMES_IN_FLIGHT = 3;
+
+// Starting capacity of the GPU arena ranges (in elements), they grow on demand
+constexpr int GPU_ARENA_INITIAL_ELEMENTS = 1024;
+
+// Starting capacity of the universal vertex/index pools, they double when a mesh doesn't fit
+constexpr int MESH_POOL_MIN_VERTICES = 1 << 16;
+constexpr int MESH_POOL_MIN_INDICES  = 1 << 18;
+
+// Post transform cache size the mesh optimizer targets (FIFO, in vertices)
+constexpr int MESH_VERTEX_CACHE_SIZE = 16;
+
+// zstd for the loose mesh binaries (the pak keeps them raw for the zero copy loads)
+// Off by default: ~2.9x smaller on disk but the loose loads are slower on a fast disk (decompression > saved reads)
+// Part of the model import settings, switching it imports the models again
+constexpr bool MESH_BINARY_COMPRESSION = false;
+constexpr int MESH_COMPRESSION_LEVEL = 9;
+// Smaller payloads go through the mesh dictionary, zstd doesn't find much in them alone
+// It's trained once from the small meshes of the first import with enough samples and never rewritten
+constexpr int MESH_DICTIONARY_MAX_PAYLOAD = 64 * 1024;
+constexpr int MESH_DICTIONARY_SIZE = 112 * 1024;
+constexpr int MESH_DICTIONARY_MIN_SAMPLES = 32;
+
+// Meshlet limits, meshes with less triangles than MESHLET_MIN_MESH_TRIANGLES are culled as a whole
+constexpr int MESHLET_MAX_VERTICES = 64;
+constexpr int MESHLET_MAX_TRIANGLES = 124;
+constexpr int MESHLET_MIN_MESH_TRIANGLES = 1024;
+
+// CPU occlusion culling, a few big and simple occluders are rasterized into a low resolution depth buffer
+// Width has to be a multiple of 4 (one SSE register per 4 pixels)
+constexpr int OCCLUSION_BUFFER_WIDTH  = 256;
+constexpr int OCCLUSION_BUFFER_HEIGHT = 128;
+constexpr int OCCLUSION_TILE_WIDTH  = 32;
+constexpr int OCCLUSION_TILE_HEIGHT = 8;
+constexpr int OCCLUSION_MAX_OCCLUDERS = 16;
+constexpr int OCCLUSION_MAX_OCCLUDER_TRIANGLES = 512;
+// Bounding radius / camera distance, smaller instances don't hide enough to pay for their triangles
+constexpr float OCCLUSION_MIN_OCCLUDER_SIZE = 0.1f;
+
+// Clustered lighting, the view frustum is split into screen tiles (x, y) and exponential depth slices (z)
+constexpr int LIGHT_CLUSTER_X = 16;
+constexpr int LIGHT_CLUSTER_Y = 9;
+constexpr int LIGHT_CLUSTER_Z = 24;
+// Point and spot lights end where their attenuation drops below this, it gives the range they are binned with
+constexpr float LIGHT_ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+// Asset DB edits are appended to a journal, the JSON is rewritten in the background once the journal gets this big
+constexpr int ASSET_JOURNAL_COMPACT_SIZE = 256 * 1024;
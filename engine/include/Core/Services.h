@@ -9,6 +9,7 @@ namespace Real {
     class Timer;
     struct EditorState;
     class AssetImporter;
+    class TaskManager;
 }
 
 namespace Real::Services {
@@ -17,6 +18,7 @@ namespace Real::Services {
     void SetEditorTimer(Timer* timer);
     void SetEditorState(EditorState* state);
     void SetAssetImporter(AssetImporter* importer);
+    void SetTaskManager(TaskManager* manager);
 }
 
 namespace Real::Services {
@@ -25,4 +27,5 @@ namespace Real::Services {
     Timer *GetEditorTimer();
     EditorState* GetEditorState();
     AssetImporter* GetAssetImporter();
+    TaskManager* GetTaskManager();
 }
\ No newline at end of file
@@ -14,6 +14,30 @@ namespace Real::fs {
         [[maybe_unused]] static bool Delete(const std::string& path);
     };
 
+    // Read-only view of a whole file, the OS pages it in on demand
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_Data != nullptr; }
+        [[nodiscard]] const uint8_t* GetData() const { return m_Data; }
+        [[nodiscard]] size_t GetSize() const { return m_Size; }
+
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+
     [[nodiscard]] std::vector<FileInfo> IterateDirectory(const std::string& folderPath);
     FileInfo CreateFileInfoFromPath(const std::string& rawPath);
     std::string NormalizePath(const std::string& path);
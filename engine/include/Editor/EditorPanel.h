@@ -32,6 +32,8 @@ namespace Real::UI {
         explicit EditorPanel(Graphics::Window* window, HierarchyPanel* hierarchyPanel, InspectorPanel* inspectorPanel);
         void BeginFrame() override;
         void Render(Scene* scene, opengl::Renderer* renderer) override;
+        // Editor UI only, the scene is already submitted (pipelined rendering)
+        void RenderUI(Scene* scene, opengl::Renderer* renderer);
         void EndFrame() override {}
         void Shutdown() override;
 
@@ -51,8 +53,8 @@ namespace Real::UI {
         void Render(Scene* scene);
 
         void RenderMenuBar();
-        void DrawPerformanceProfile();
-        void UpdateInputUI();
+        void DrawPerformanceProfile(const Scene* scene);
+        void UpdateInputUI(Scene* scene);
 
         void InitFontStyle();
         void InitDarkTheme();
@@ -11,5 +11,17 @@ namespace Real {
         Entity* camera{};
         bool Running = true;
         bool FpsMode = true;
+        // Simulate frame N+1 on a worker while frame N is submitted
+        bool PipelinedRendering = false;
+        bool FrustumCulling = true;
+        // Culling runs in a compute pass instead of the extraction (needs FrustumCulling)
+        bool GPUCulling = true;
+
+        // Render stats of the last submitted frame
+        uint32_t VisibleInstances = 0;
+        uint32_t CulledInstances = 0;
+        uint32_t OccludedInstances = 0;
+        uint32_t VisibleMeshlets = 0;
+        uint32_t CulledMeshlets = 0;
     };
 }
@@ -7,11 +7,19 @@
 #include <vector>
 
 #include "Common/RealEnum.h"
+#include "Core/RealConfig.h"
 #include "Core/Logger.h"
 #include "glad/glad.h"
 
 namespace Real::opengl {
 
+    // Range to keep while the buffer is reallocated, offsets are relative to a region
+    struct BufferCopy {
+        GLintptr m_SrcOffset = 0;
+        GLintptr m_DstOffset = 0;
+        GLsizeiptr m_Size = 0;
+    };
+
     struct Buffer {
         Buffer() = default;
         Buffer(const Buffer&) = default;
@@ -27,6 +35,9 @@ namespace Real::opengl {
         void Create(const std::vector<T>& data, GLsizeiptr size, BufferType type) {
             CleanResources();
             m_Size = size;
+            m_RegionSize = size;
+            m_RegionCount = 1;
+            m_Region = 0;
             Create(data, type);
         }
 
@@ -35,24 +46,31 @@ namespace Real::opengl {
         void Create(const T& data, GLsizeiptr size, BufferType type) {
             CleanResources();
             m_Size = size;
+            m_RegionSize = size;
+            m_RegionCount = 1;
+            m_Region = 0;
             Create(std::vector{data}, type);
         }
 
+        // Persistent mapped SSBO split into regions, one per frame in flight
+        // Every region is fenced, BeginFrame waits until the GPU is done with the next one
+        void CreateRing(GLsizeiptr regionSize, uint32_t regionCount = GPU_FRAMES_IN_FLIGHT);
+        void BeginFrame();
+        void EndFrame();
+        // Reallocate with a new region size, the given ranges are copied on the GPU (in every region)
+        void Relayout(GLsizeiptr newRegionSize, const std::vector<BufferCopy>& copies);
+
         template <typename T>
         void UploadToGPU(const std::vector<T>& data, GLsizeiptr size, BufferType type) {
             if (data.empty()) return;
             if (type == BufferType::SSBO) {
-                if (m_Size <= size) {
-                    m_Size *= 2;
-                    if (m_Ptr) {
-                        Create(data, type);
-                    }
+                if (size > m_RegionSize) {
+                    Grow(size);
                 }
-                else {
-                    if (m_Ptr) {
-                        memcpy(m_Ptr, data.data(), size);
-                        glFlushMappedNamedBufferRange(m_Buffer, 0, size);
-                    }
+                if (m_Ptr) {
+                    // Current region only, others may be in use by the GPU
+                    memcpy(static_cast<uint8_t*>(m_Ptr) + GetRegionOffset(), data.data(), size);
+                    glFlushMappedNamedBufferRange(m_Buffer, GetRegionOffset(), size);
                 }
             }
             else if (type == BufferType::UBO) {
@@ -67,14 +85,31 @@ namespace Real::opengl {
             }
         }
 
+        // Persistent mapped SSBOs only, writes are visible to the GPU after FlushRange
+        // Offsets are relative to the current region
+        void Write(const void* data, GLintptr offset, GLsizeiptr size) const;
+        void FlushRange(GLintptr offset, GLsizeiptr size) const;
+
+        // Binds the current region only (whole buffer if it's not a ring)
         void Bind(GLenum target, BufferType type, GLuint bindingPoint) const;
 
+        [[nodiscard]] bool IsRing() const { return m_RegionCount > 1; }
+        [[nodiscard]] GLintptr GetRegionOffset() const { return static_cast<GLintptr>(m_Region) * m_RegionSize; }
+        [[nodiscard]] GLsizeiptr GetRegionSize() const { return m_RegionSize; }
+        [[nodiscard]] uint32_t GetRegion() const { return m_Region; }
+
     private:
         GLuint m_Buffer = 0;
         void* m_Ptr = nullptr;
         GLsizeiptr m_Size = 0;
         GLbitfield m_Flags = GL_MAP_PERSISTENT_BIT | GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
 
+        // Single region unless it's created with CreateRing
+        GLsizeiptr m_RegionSize = 0;
+        uint32_t m_RegionCount = 1;
+        uint32_t m_Region = 0;
+        std::vector<GLsync> m_Fences;
+
     private:
         template <typename T>
         void Create(const std::vector<T>& data, BufferType type) {
@@ -103,6 +138,8 @@ namespace Real::opengl {
             }
         }
 
+        // Bigger regions, the old content is copied on the GPU
+        void Grow(GLsizeiptr requiredRegionSize);
         void CleanResources();
     };
 
@@ -0,0 +1,37 @@
+//
+// Created by pointerlost on 1/15/26.
+//
+#pragma once
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace Real::opengl {
+
+    // Hi-Z pyramid of the default framebuffer depth (shaders/opengl/hiz.comp)
+    // Every texel of a mip is the farthest depth of the texels it covers, so a test against it is conservative
+    class DepthPyramid {
+    public:
+        DepthPyramid() = default;
+        DepthPyramid(const DepthPyramid&) = delete;
+        DepthPyramid& operator=(const DepthPyramid&) = delete;
+        ~DepthPyramid();
+
+        // Copies the current depth and reduces it, recreated when the viewport size changes
+        void Build();
+        void Bind(GLuint unit) const { glBindTextureUnit(unit, m_Pyramid); }
+
+        [[nodiscard]] bool IsValid() const { return m_Pyramid != 0; }
+
+    private:
+        GLuint m_DepthCopy = 0; // Same format as the window depth, glBlitFramebuffer can't convert
+        GLuint m_DepthFBO = 0;
+        GLuint m_Pyramid = 0;   // R32F, full resolution at mip 0
+        int m_Width = 0;
+        int m_Height = 0;
+        int m_Levels = 0;
+
+    private:
+        void Resize(int width, int height);
+        void Release();
+    };
+}
@@ -0,0 +1,66 @@
+//
+// Created by pointerlost on 1/11/26.
+//
+#pragma once
+#include <vector>
+#include "Buffer.h"
+
+namespace Real::opengl {
+
+    // Index of a suballocation inside the arena
+    struct ArenaRange {
+        uint32_t m_Index = UINT32_MAX;
+        [[nodiscard]] bool IsValid() const { return m_Index != UINT32_MAX; }
+    };
+
+    // One persistent mapped ring buffer shared by all the per-frame SSBOs
+    // Ranges are linearly suballocated and aligned to GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT,
+    // writes are collected and flushed once per frame
+    class GPUArena {
+    public:
+        // Ranges are reserved before Create, they grow on demand afterward
+        ArenaRange Allocate(GLsizeiptr capacity);
+        void Create(uint32_t regionCount = GPU_FRAMES_IN_FLIGHT);
+
+        void BeginFrame();
+        void EndFrame();
+
+        // Offset is relative to the range
+        void Write(const ArenaRange& range, const void* data, GLintptr offset, GLsizeiptr size);
+        template <typename T>
+        void Upload(const ArenaRange& range, const std::vector<T>& data) {
+            if (data.empty()) return;
+            Write(range, data.data(), 0, static_cast<GLsizeiptr>(data.size() * sizeof(T)));
+        }
+        // Single flush over everything written this frame
+        void Flush();
+
+        [[nodiscard]] GLuint GetHandle() const { return m_Buffer.GetHandle(); }
+        // Absolute offset in the buffer (current region included), ready for binding
+        [[nodiscard]] GLintptr GetOffset(const ArenaRange& range) const;
+        [[nodiscard]] GLsizeiptr GetSize(const ArenaRange& range) const { return m_Ranges[range.m_Index].m_Capacity; }
+        [[nodiscard]] GLsizeiptr GetRegionSize() const { return m_Buffer.GetRegionSize(); }
+        [[nodiscard]] uint32_t GetRegion() const { return m_Buffer.GetRegion(); }
+
+    private:
+        struct Allocation {
+            GLintptr m_Offset = 0; // Relative to the region
+            GLsizeiptr m_Capacity = 0;
+        };
+
+        Buffer m_Buffer{};
+        std::vector<Allocation> m_Ranges;
+        GLsizeiptr m_Alignment = 256;
+        bool m_Created = false;
+
+        // Written span of the current region, relative to the region
+        GLintptr m_DirtyBegin = 0;
+        GLintptr m_DirtyEnd = 0;
+
+    private:
+        GLsizeiptr Align(GLsizeiptr size) const { return (size + m_Alignment - 1) / m_Alignment * m_Alignment; }
+        // Packs the ranges back to back, returns the region size
+        GLsizeiptr Layout(std::vector<Allocation>& ranges) const;
+        void GrowRange(uint32_t index, GLsizeiptr requiredCapacity);
+    };
+}
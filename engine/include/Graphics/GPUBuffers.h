@@ -2,6 +2,7 @@
 // Created by pointerlost on 10/13/25.
 //
 #pragma once
+#include <cstdint>
 #include <glm/ext.hpp>
 
 namespace Real {
@@ -14,7 +15,7 @@ namespace Real {
     struct LightSSBO {
         glm::vec4 pos_cutoff{0.0}; // vec3 = position, float = cutoff
         glm::vec4 dir_outer{0.0}; // vec3 direction, float = outerCutoff
-        glm::vec4 radiance{0.0};
+        glm::vec4 radiance{0.0}; // w = range (Light::GetRange)
         int type = 0;
         // Attenuation parameters
         float constant = 1.0;
@@ -46,6 +47,14 @@ namespace Real {
     struct GlobalUBO {
         glm::vec4 GlobalAmbient{0.1};
         int lightCount[4]; // 0 = light count, other indices padding
+        glm::uvec4 clusterGrid{0}; // xyz = cluster counts, w unused
+        glm::vec4 clusterDepth{0.0}; // x = near, y = far, z = log(far / near), w unused
+    };
+
+    // Light grid cell, a range of the light index list
+    struct LightClusterSSBO {
+        uint32_t offset = 0;
+        uint32_t count = 0;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// Created by pointerlost on 1/14/26.
+//
+#pragma once
+#include <cstdint>
+#include <glad/glad.h>
+#include "DepthPyramid.h"
+
+namespace Real::opengl {
+
+    enum class CullPhase : int {
+        FRUSTUM = 0, // Frustum only, single pass
+        EARLY   = 1, // Instances visible last frame, they fill the depth for the pyramid
+        LATE    = 2, // Everything else tested against the pyramid, updates the visibility
+    };
+
+    // Counted on the GPU, read back GPU_FRAMES_IN_FLIGHT frames later
+    struct CullStats {
+        uint32_t visible = 0;
+        uint32_t frustumCulled = 0;
+        uint32_t occluded = 0;
+        uint32_t pad = 0;
+    };
+
+    // Frustum culling in a compute pass (shaders/opengl/cull.comp), the CPU only uploads the unculled frame data
+    // Surviving instances are appended to their command and the non-empty commands are compacted,
+    // the draw count stays on the GPU (glMultiDrawElementsIndirectCount)
+    // Occlusion is two phase: last frame's visible set is drawn first, the Hi-Z pyramid is built from its depth
+    // and the rest is tested against it
+    class GPUCulling {
+    public:
+        GPUCulling() = default;
+        GPUCulling(const GPUCulling&) = delete;
+        GPUCulling& operator=(const GPUCulling&) = delete;
+        ~GPUCulling();
+
+        void Init();
+        // Frame data has to be bound already (RenderContext::BindGPUBuffers + the mesh table)
+        void Dispatch(uint32_t commandCount, uint32_t instanceCount, CullPhase phase = CullPhase::FRUSTUM);
+        // Between the early and late pass, from the depth of the early draws
+        void BuildDepthPyramid() { m_DepthPyramid.Build(); }
+        // Instance indices change with the rebuilt commands, so everything is visible again
+        void SyncVisibility(uint64_t commandsVersion);
+        // Culled entity data goes to binding 1 for the main pass
+        void BindForDraw() const;
+        void Draw(uint32_t commandCount) const;
+
+        // Stats of the frame which used the arena region last (fenced already, RenderContext::UploadToGPU)
+        [[nodiscard]] CullStats ReadStats(uint32_t region) const;
+        // After the frame's last dispatch
+        void CopyStats(uint32_t region) const;
+
+        // GL 4.6, otherwise every command is submitted and the culled ones have zero instances
+        [[nodiscard]] bool SupportsDrawCount() const { return m_SupportsDrawCount; }
+
+    private:
+        GLuint m_ScratchCommands = 0;
+        GLuint m_Commands = 0;
+        GLuint m_EntityData = 0;
+        GLuint m_DrawCount = 0;
+        GLuint m_Visibility = 0;
+        GLuint m_Stats = 0;
+        GLuint m_StatsReadback = 0; // One CullStats per arena region, persistently mapped
+        const CullStats* m_MappedStats = nullptr;
+        DepthPyramid m_DepthPyramid;
+        uint64_t m_VisibilityVersion = UINT64_MAX;
+        uint32_t m_CommandCapacity = 0;
+        uint32_t m_InstanceCapacity = 0;
+        bool m_SupportsDrawCount = false;
+
+    private:
+        void Reserve(uint32_t commandCount, uint32_t instanceCount);
+    };
+}
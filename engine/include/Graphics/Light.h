@@ -39,6 +39,8 @@ namespace Real {
         [[nodiscard]] float GetOuterCutOff() const { return m_OuterCutOff; }
 
         [[nodiscard]] LightType GetType() const { return m_Type; }
+        // Distance where the attenuation drops below LIGHT_ATTENUATION_CUTOFF, infinite for the directional lights
+        [[nodiscard]] float GetRange() const;
 
         void Update(Transformations& transform);
         [[nodiscard]] LightSSBO ConvertToGPUFormat(Transformations& transform);
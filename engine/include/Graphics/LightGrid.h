@@ -0,0 +1,46 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "GPUBuffers.h"
+
+namespace Real {
+
+    // Clustered forward lighting: the lights touching every cluster of the view frustum,
+    // so a fragment only loops over the lights of its own cluster (see main.frag)
+    // Depth slices are binned in parallel on the job system
+    class LightGrid {
+    public:
+        // Lights are in world space, the clusters follow the camera's projection
+        void Build(const CameraUBO& camera, const std::vector<LightSSBO>& lights,
+            std::vector<LightClusterSSBO>& clusters, std::vector<uint32_t>& lightIndices);
+
+        [[nodiscard]] float GetNear() const { return m_Near; }
+        [[nodiscard]] float GetFar()  const { return m_Far;  }
+
+    private:
+        // View space bounds of a light (directional ones cover everything)
+        struct LightBounds {
+            glm::vec3 m_Center{0.0f};
+            float m_Radius = 0.0f;
+            bool m_Infinite = false;
+        };
+        struct ClusterBounds {
+            glm::vec3 m_Min{0.0f};
+            glm::vec3 m_Max{0.0f};
+        };
+
+        glm::mat4 m_Projection{0.0f};
+        float m_Near = 0.1f;
+        float m_Far = 1000.0f;
+        std::vector<ClusterBounds> m_Bounds; // Rebuilt only when the projection changes
+        std::vector<LightBounds> m_Lights;
+        std::vector<std::vector<uint32_t>> m_SliceIndices; // Per depth slice, merged after the parallel pass
+
+    private:
+        void BuildClusterBounds(const glm::mat4& projection);
+        void BinSlice(uint32_t slice, std::vector<LightClusterSSBO>& clusters);
+    };
+}
@@ -6,44 +6,93 @@
 #include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
+#include "Common/RangeAllocator.h"
 #include "Common/RealTypes.h"
+#include "Common/SlotMap.h"
 #include "Core/UUID.h"
 
 namespace Real { struct OpenGLTexture; }
 
 namespace Real {
 
+    // Per mesh entry of the mesh table SSBO, indexed by the mesh handle index
+    struct MeshGPUData {
+        glm::vec4 m_BoundsMin{0.0f};    // w unused
+        glm::vec4 m_BoundsExtent{0.0f}; // w unused
+    };
+
     // TODO: MeshManager vs MeshData wrong naming fix it this shit
     class MeshData {
     public:
         void InitResources();
 
+        // Bounds are computed from the vertices
         const MeshAsset& CreateSingleMesh(std::vector<Vertex> vertices,
             const std::vector<uint32_t>& indices, const UUID& meshUUID
         );
+        // Bounds are already known (imported or read from the mesh binary)
+        const MeshAsset& CreateSingleMesh(std::vector<Vertex> vertices,
+            const std::vector<uint32_t>& indices, const UUID& meshUUID, const AABB& bounds
+        );
+        // Already packed against the given bounds (compact mesh binaries), copied once into the pools
+        // The spans can point into a mapped file (asset pak)
+        const MeshAsset& CreateSingleMesh(std::span<const PackedVertex> vertices,
+            std::span<const uint32_t> indices, const UUID& meshUUID, const AABB& bounds
+        );
+        // Frees the pool ranges, they are reused by the next meshes
+        bool RemoveMesh(const UUID& meshUUID);
+        // Dense meshes only, ranges are relative to the mesh indices
+        void SetMeshlets(const UUID& meshUUID, std::vector<Meshlet> meshlets);
+        [[nodiscard]] std::span<const Meshlet> GetMeshlets(const MeshHandle& handle) const;
+        // Increased on every new/removed mesh (and meshlet change), cached draw data and handles have to be rebuilt when it changes
+        [[nodiscard]] uint64_t GetVersion() const { return m_Version; }
 
-        std::span<const Vertex> ViewVertices(const UUID& uuid) const;
+        std::span<const PackedVertex> ViewVertices(const UUID& uuid) const;
         std::span<const uint32_t> ViewIndices(const UUID& uuid) const;
 
-        const std::unordered_map<UUID, MeshAsset>& GetAllMeshes() { return m_MeshAssets; }
+        const std::unordered_map<UUID, MeshHandle>& GetAllMeshes() { return m_MeshHandles; }
         [[nodiscard]] const MeshAsset* GetMeshData(const UUID& uuid) const;
+        // Per frame code should resolve the UUID once and keep the handle
+        [[nodiscard]] MeshHandle GetMeshHandle(const UUID& uuid) const;
+        [[nodiscard]] const MeshAsset* GetMeshData(const MeshHandle& handle) const { return m_MeshAssets.Get(handle); }
         [[maybe_unused]] const MeshAsset &GetPrimitiveMeshData(const std::string& name);
         [[maybe_unused]] const UUID& GetPrimitiveUUID(const std::string& name);
         [[nodiscard]] GLuint GetUniversalVAO() const { return m_UniversalVAO; }
-        void BindUniversalVAO() const { glBindVertexArray(m_UniversalVAO); }
+        // The mesh table goes with the VAO, positions can't be decoded without it
+        void BindUniversalVAO() const {
+            glBindVertexArray(m_UniversalVAO);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, m_MeshTableBuffer);
+        }
         void UnbindCurrVAO() const { glBindVertexArray(0); }
 
-        [[nodiscard]] size_t GetVerticesCount() const { return m_AllVertices.size(); }
-        [[nodiscard]] size_t GetIndicesCount()  const { return m_AllIndices.size(); }
+        // Used part of the pools
+        [[nodiscard]] size_t GetVerticesCount() const { return m_VertexPool.GetUsed(); }
+        [[nodiscard]] size_t GetIndicesCount()  const { return m_IndexPool.GetUsed(); }
         void LoadPrimitiveTypes();
 
     private:
-        std::unordered_map<UUID, MeshAsset> m_MeshAssets;
+        SlotMap<MeshAsset> m_MeshAssets;
+        std::unordered_map<UUID, MeshHandle> m_MeshHandles; // Persistence only
         std::unordered_map<std::string, UUID> m_PrimitiveTypesUUIDs;
-        std::vector<Vertex> m_AllVertices;
-        std::vector<uint32_t> m_AllIndices;
+        // CPU mirror of the pools, same layout as the GPU buffers
+        std::vector<PackedVertex> m_AllVertices;
+        std::vector<uint32_t> m_AllIndices; // Local to the mesh, draws use baseVertex
+        RangeAllocator m_VertexPool;
+        RangeAllocator m_IndexPool;
+        uint64_t m_Version = 0;
+        std::vector<MeshGPUData> m_MeshTable;
+        std::vector<std::vector<Meshlet>> m_Meshlets; // Indexed by the mesh handle index
 
         unsigned int m_UniversalVAO = 0, m_VBO = 0, m_EBO = 0;
+        unsigned int m_MeshTableBuffer = 0;
+
+    private:
+        uint64_t AllocateVertices(uint64_t count);
+        uint64_t AllocateIndices(uint64_t count);
+        // Bigger GPU buffer, the old content is copied on the GPU
+        void ResizeGPUBuffer(GLuint& buffer, GLsizeiptr oldSize, GLsizeiptr newSize);
+        void UploadRange(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) const;
+        void WriteMeshTable(const MeshHandle& handle, const AABB& bounds);
     };
 
     class MeshData3D final : public MeshData {
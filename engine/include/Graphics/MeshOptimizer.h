@@ -0,0 +1,46 @@
+//
+// Created by pointerlost on 1/13/26.
+//
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Common/RealTypes.h"
+#include "Core/RealConfig.h"
+
+namespace Real {
+
+    struct MeshOptimizeStats {
+        float m_ACMRBefore = 0.0f;
+        float m_ACMRAfter = 0.0f;
+    };
+
+    // Import time index/vertex reordering, every function is thread-safe (no engine state)
+    class MeshOptimizer {
+    public:
+        // Cache -> overdraw -> fetch, in place
+        static MeshOptimizeStats Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Tipsify (Sander et al. 2007), clusters gets the first triangle of every hard boundary (dead-end restart)
+        static std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+            std::vector<uint32_t>* clusters = nullptr, uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE
+        );
+        // Clusters are split where the cache allows it and sorted by how much they face away from the mesh center
+        // threshold is the allowed ACMR increase of a split cluster (1.05 = 5%)
+        static std::vector<uint32_t> OptimizeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices,
+            std::span<const uint32_t> clusters, float threshold = 1.05f, uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE
+        );
+        // Vertices are renumbered in first use order, unreferenced ones are dropped
+        static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Splits the (already optimized) triangle order into contiguous ranges, the order isn't changed
+        static std::vector<Meshlet> BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+            uint32_t maxVertices = MESHLET_MAX_VERTICES, uint32_t maxTriangles = MESHLET_MAX_TRIANGLES
+        );
+
+        // Average cache miss ratio (misses per triangle) with a FIFO cache
+        [[nodiscard]] static float ComputeACMR(std::span<const uint32_t> indices, size_t vertexCount,
+            uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE
+        );
+    };
+}
@@ -7,9 +7,14 @@
 #include <assimp/scene.h>
 #include <string>
 #include "MeshManager.h"
+#include "MeshOptimizer.h"
 #include "Texture.h"
 #include "Common/RealTypes.h"
 
+namespace Assimp {
+    class Importer;
+}
+
 namespace Real {
     struct Model;
     struct Material;
@@ -17,14 +22,54 @@ namespace Real {
 
 namespace Real {
 
+    // Mesh data extracted on a worker, UUIDs and offsets are assigned at commit time
+    struct ImportedMesh {
+        std::vector<Vertex> m_Vertices;
+        std::vector<uint32_t> m_Indices;
+        unsigned int m_MaterialIndex = 0;
+        MeshBinaryHeader m_Header{};
+        MeshOptimizeStats m_OptimizeStats{};
+        std::vector<Meshlet> m_Meshlets; // Dense meshes only
+    };
+
+    // Everything a worker reads for a single model file
+    struct ModelImportContext {
+        std::string m_FilePath;
+        std::string m_Name;
+        std::string m_Directory;
+        bool m_IsFBX = false;
+        VertexFormat m_VertexFormat = VertexFormat::COMPACT; // Layout of the written mesh binaries
+        uint64_t m_SourceHash = 0; // See ModelLoader::HashSource
+        Scope<Assimp::Importer> m_Importer; // Owns the scene, materials are processed at commit time
+        const aiScene* m_Scene = nullptr;
+        std::vector<ImportedMesh> m_Meshes;
+        std::unordered_map<std::string, std::vector<std::filesystem::path>> m_TextureIndex;
+
+        ModelImportContext();
+        ~ModelImportContext();
+    };
+
     class ModelLoader {
     public:
         void LoadAll(const std::string& rootDir);
-        Ref<Model> Load(const std::string& filePath, const std::string& name, ImageFormatState state = ImageFormatState::COMPRESS_ME);
+        Ref<Model> Load(const std::string& filePath, const std::string& name, ImageFormatState state = ImageFormatState::COMPRESS_ME,
+            VertexFormat vertexFormat = VertexFormat::COMPACT
+        );
+        // Import settings (flags, vertex format, mesh versions), stored next to the source hash
+        [[nodiscard]] static uint64_t HashSettings(VertexFormat vertexFormat = VertexFormat::COMPACT);
+        // XXH64 of the model file seeded with HashSettings, 0 if it can't be read
+        [[nodiscard]] static uint64_t HashSource(const std::string& filePath, VertexFormat vertexFormat = VertexFormat::COMPACT);
 
     private:
-        void ProcessNode(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parentTransform);
-        void ProcessMesh(const aiMesh* mesh, const aiScene* scene, const aiMatrix4x4& transform);
+        // Thread-safe, doesn't touch the engine state
+        static bool ReadScene(ModelImportContext& ctx);
+        static void CollectNodeMeshes(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parentTransform,
+            std::vector<std::pair<const aiMesh*, aiMatrix4x4>>& out
+        );
+        static void ExtractMesh(const aiMesh* mesh, const aiMatrix4x4& transform, ImportedMesh& out);
+
+        // Main thread only, registers the model to the managers and the DB
+        Ref<Model> CommitModel(ModelImportContext& ctx, ImageFormatState state);
         Ref<Material> ProcessMaterial(const aiMaterial* mat, int materialIndex);
         void AddTextureToMaterial(const Ref<OpenGLTexture>& tex, const Ref<Material>& material);
         void SaveModelTextureAsFile(const Ref<OpenGLTexture>& tex);
@@ -32,7 +77,6 @@ namespace Real {
         std::filesystem::path ChooseBest(const std::vector<std::filesystem::path>& paths);
 
     private:
-        bool m_IsFBX = false;
         Ref<Model> m_CurrentModel;
         std::string m_CurrentDirectory;
         ImageFormatState m_CurrImageFormatState = ImageFormatState::COMPRESS_ME;
@@ -19,5 +19,6 @@ namespace Real {
         int materialIndex;
         int indexCount;
         int indexOffset;
+        int meshIndex; // Mesh table entry, needed to decode the packed vertices
     } EntityMetadata;
 }
\ No newline at end of file
@@ -2,42 +2,88 @@
 // Created by pointerlost on 10/13/25.
 //
 #pragma once
+#include <array>
+#include <span>
 #include <unordered_map>
 
 #include "GPUBuffers.h"
 #include "RenderCommand.h"
 #include <vector>
+#include <entt/entt.hpp>
 #include "Buffer.h"
+#include "GPUArena.h"
+#include "GPUCulling.h"
+#include "LightGrid.h"
 #include "Core/UUID.h"
+#include "Common/RealTypes.h"
+#include "Math/OcclusionBuffer.h"
 
 namespace Real {
-    struct RenderableData;
-    struct MeshAsset;
     struct TransformComponent;
-    class Entity;
+    struct MeshRendererComponent;
     class Scene;
+    namespace math { class Frustum; }
 }
 
 namespace Real {
 
+    // Transform which changed since the last extraction, written to its persistent slot
+    struct TransformDelta {
+        uint32_t slot;
+        TransformSSBO data;
+    };
+
     struct GPUData {
-        std::vector<TransformSSBO> transforms;
+        std::vector<TransformDelta> transforms;
         std::vector<MaterialSSBO> materials;
         std::vector<GLuint64> textures;
         std::vector<LightSSBO> lights;
+        std::vector<LightClusterSSBO> lightClusters;
+        std::vector<uint32_t> lightIndices;
         std::vector<DrawElementsIndirectCommand> drawCommands;
         std::vector<EntityMetadata> entityData;
         CameraUBO camera;
         GlobalUBO globalData;
+
+        // Draw commands, entity data and materials are copied only when the scene structure changed
+        // (or every frame for the commands if the culling is on)
+        uint64_t commandsVersion = 0;
+        uint64_t materialsVersion = 0;
+        // Uploads left, one per ring buffer region
+        uint32_t commandsDirty = 0;
+        uint32_t materialsDirty = 0;
+
+        // Instances after the frustum culling
+        uint32_t visibleCount = 0;
+        uint32_t culledCount = 0;
+        // Inside the frustum but behind the occluders (CPU occlusion culling)
+        uint32_t occludedCount = 0;
+        // Meshlets of the visible instances (dense meshes only)
+        uint32_t visibleMeshlets = 0;
+        uint32_t culledMeshlets = 0;
+    };
+
+    // Renderables sharing the same mesh and material, drawn with a single instanced command
+    struct DrawBatch {
+        MeshAsset mesh{}; // Copy, the mesh storage may grow after the rebuild
+        int meshIndex = 0; // Mesh table entry (mesh handle index)
+        std::span<const Meshlet> meshlets; // Empty for small meshes, mesh changes force a rebuild
+        int materialIndex = 0;
+        std::vector<int> transformIndices;
     };
 
     struct GPUBuffers {
-        opengl::Buffer transform;
-        opengl::Buffer material;
+        // Per frame SSBOs are ranges of one arena
+        opengl::GPUArena arena;
+        opengl::ArenaRange transform;
+        opengl::ArenaRange material;
+        opengl::ArenaRange light;
+        opengl::ArenaRange lightCluster;
+        opengl::ArenaRange lightIndex;
+        opengl::ArenaRange drawCommand;
+        opengl::ArenaRange entityData;
+
         opengl::Buffer texture;
-        opengl::Buffer light;
-        opengl::Buffer drawCommand;
-        opengl::Buffer entityData;
         opengl::Buffer camera;
         opengl::Buffer globalData;
     };
@@ -47,27 +93,86 @@ namespace Real {
         explicit RenderContext(Scene* scene);
         void InitResources();
         void BindGPUBuffers() const;
+        // Serial path: extract, swap and upload in one go
         void CollectRenderables();
 
-        GPUData& GetGPURenderData() { return m_GPUDatas; }
-        [[nodiscard]] const GPUData& GetGPURenderData() const { return m_GPUDatas; }
+        // Fill the back snapshot from the scene, pure CPU (can run on a worker while the front one is submitted)
+        void ExtractFrame();
+        // Upload the front snapshot, GL thread only
+        void UploadToGPU();
+        // Back snapshot becomes the one to submit
+        void SwapFrames();
+        // Fence the arena region, after the frame's draw calls
+        void EndFrame();
+
+        void SetBindlessTextures(const std::vector<GLuint64>& textures);
+
+        // Front snapshot, the one the renderer submits
+        GPUData& GetGPURenderData() { return m_Frames[m_FrontIndex]; }
+        [[nodiscard]] const GPUData& GetGPURenderData() const { return m_Frames[m_FrontIndex]; }
         [[nodiscard]] const GPUBuffers& GetBuffers() const { return m_Buffers; }
+        [[nodiscard]] opengl::GPUCulling& GetGPUCulling() { return m_GPUCulling; }
 
     private:
-        GPUData m_GPUDatas{};
+        // Double buffered frame data, the extraction writes the back one while the front one is rendered
+        std::array<GPUData, 2> m_Frames{};
+        uint32_t m_FrontIndex = 0;
+        // False between SwapFrames and UploadToGPU, the front deltas aren't on the GPU yet
+        bool m_FrontUploaded = true;
         GPUBuffers m_Buffers{};
+        opengl::GPUCulling m_GPUCulling;
         Scene* m_Scene;
-        std::unordered_map<UUID, int> m_MaterialIdxCache;
+
+        // Persistent extraction state, rebuilt only on structural changes (entity, mesh renderer added/removed)
+        bool m_StructureDirty = true;
+        uint64_t m_CommandsVersion = 0;
+        uint64_t m_MeshVersion = 0;
+        std::vector<DrawBatch> m_Batches;
+        std::vector<DrawElementsIndirectCommand> m_DrawCommands;
+        std::vector<EntityMetadata> m_EntityData;
+        std::vector<MaterialSSBO> m_Materials;
+        std::vector<int> m_MaterialIdxCache; // Material handle index -> materials index, -1 if not pushed yet
+
+        // Transform SSBO slots, one per entity for its whole lifetime
+        uint32_t m_NextTransformSlot = 0;
+        std::vector<uint32_t> m_FreeTransformSlots;
+        // Last model matrix written to each slot
+        std::vector<glm::mat4> m_SlotMatrices;
+        // Deltas not written yet to each transform ring region
+        std::array<std::vector<TransformDelta>, GPU_FRAMES_IN_FLIGHT> m_PendingTransforms;
+
+        // CPU occlusion culling, occluder positions are decoded once per mesh (mesh handle index -> positions)
+        math::OcclusionBuffer m_OcclusionBuffer;
+        std::unordered_map<int, std::vector<glm::vec3>> m_OccluderPositions;
+
+        LightGrid m_LightGrid;
 
     private:
-        void CollectLight(const Entity* entity);
-        void CollectCamera(const Entity* entity);
-        int PushTransform(TransformComponent& tc);
-        int PushMaterial(const UUID& materialUUID);
-        void PushDrawCommand(const MeshAsset* mesh, int transformIndex, int materialIndex, uint baseInstance);
-        std::vector<RenderableData> CollectRenderables(const Entity* entity);
+        void RebuildDrawCommands();
+        void CollectLights();
+        void CollectCamera();
+        void PushTransform(TransformComponent& tc);
+        int PushMaterial(const MaterialHandle& material);
+        void PushDrawCommand(const DrawBatch& batch, std::span<const int> transformIndices,
+            std::vector<DrawElementsIndirectCommand>& commands, std::vector<EntityMetadata>& entityData);
+        void CullDrawCommands(GPUData& frame);
+        // Biggest simple meshes on the screen go to the occlusion buffer
+        void RasterizeOccluders(const GPUData& frame, const math::Frustum& frustum);
+        const std::vector<glm::vec3>& GetOccluderPositions(const DrawBatch& batch);
+        // One command per run of visible meshlets, all of them share the instance's entity data
+        void PushMeshletCommands(const DrawBatch& batch, int transformIndex, const math::Frustum& frustum,
+            const glm::vec3& cameraPos, GPUData& frame);
+        [[nodiscard]] static EntityMetadata MakeEntityMetadata(const DrawBatch& batch, int transformIndex);
+        std::vector<RenderableData> CollectRenderables(MeshRendererComponent& mrc);
         void CollectGlobalData();
         void CleanPrevFrame();
-        void UploadToGPU();
+        void QueueTransforms(const std::vector<TransformDelta>& frameDeltas);
+        void UploadTransforms(const std::vector<TransformDelta>& frameDeltas);
+
+        uint32_t AllocateTransformSlot();
+        void OnStructureChanged(entt::registry& registry, entt::entity entity);
+        void OnTransformDestroyed(entt::registry& registry, entt::entity entity);
+
+        GPUData& Back() { return m_Frames[m_FrontIndex ^ 1]; }
     };
 }
@@ -12,6 +12,8 @@ namespace Real {
     class Shader {
     public:
         Shader(std::string vertexPath, std::string fragmentPath, std::string name);
+        // Compute only program
+        Shader(std::string computePath, std::string name);
         Shader() = default;
         Shader(Shader&&) = default;
         Shader& operator=(Shader&&) = default;
@@ -35,11 +37,14 @@ namespace Real {
         [[nodiscard]] const std::string& GetName() const { return m_Name; }
         [[nodiscard]] const GLuint& GetProgram() const { return m_Program; }
         void Bind() const { glUseProgram(m_Program); }
+        // Group counts, the program has to be bound
+        void Dispatch(GLuint x, GLuint y = 1, GLuint z = 1) const { glDispatchCompute(x, y, z); }
 
     private:
         GLuint m_Program;
         std::string m_VertexPath;
         std::string m_FragmentPath;
+        std::string m_ComputePath;
         std::string m_Name;
 
         mutable std::unordered_map<std::string, int> m_CacheUniforms;
@@ -17,7 +17,7 @@ namespace Real {
         ~Transformations() = default;
         Transformations(Transformations&) = default;
 
-        void SetModelMatrix(const glm::mat4& model) { m_ModelMatrix = model; }
+        void SetModelMatrix(const glm::mat4& model) { m_ModelMatrix = model; m_GPUDirty = true; }
         // To update gizmos
         [[nodiscard]] glm::mat4& GetModelMatrix() { m_ModelMatrixDirty = false; return m_ModelMatrix; }
         [[nodiscard]] const glm::mat4& GetModelMatrix() const { return m_ModelMatrix; }
@@ -71,6 +71,10 @@ namespace Real {
         void Update();
         [[nodiscard]] TransformSSBO ConvertToGPUFormat();
 
+        // Model matrix changed since the last render extraction
+        [[nodiscard]] bool IsGPUDirty() const { return m_GPUDirty || m_ModelMatrixDirty; }
+        void ClearGPUDirty() { m_GPUDirty = false; }
+
     private:
         glm::vec3 m_Translate = glm::vec3(0.0f);
         glm::quat m_Rotate = glm::identity<glm::quat>();
@@ -83,5 +87,6 @@ namespace Real {
 
         glm::mat4 m_ModelMatrix = glm::mat4(1.0f);
         mutable bool m_ModelMatrixDirty = true;
+        bool m_GPUDirty = true;
     };
 }
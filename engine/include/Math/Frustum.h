@@ -0,0 +1,26 @@
+//
+// Created by pointerlost on 1/9/26.
+//
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Real::math {
+
+    // View frustum planes extracted from a view projection matrix (Gribb/Hartmann)
+    // Planes are stored as SoA so a sphere is tested against 4 planes at once
+    class Frustum {
+    public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        // World space sphere, false if it's completely outside of any plane
+        [[nodiscard]] bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+    private:
+        // 6 planes padded to 8 (the padding planes never cull)
+        alignas(16) float m_PlaneX[8]{};
+        alignas(16) float m_PlaneY[8]{};
+        alignas(16) float m_PlaneZ[8]{};
+        alignas(16) float m_PlaneW[8]{};
+    };
+}
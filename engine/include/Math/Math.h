@@ -2,10 +2,23 @@
 // Created by pointerlost on 10/20/25.
 //
 #pragma once
+#include <span>
 #include <glm/glm.hpp>
+#include "Common/RealTypes.h"
 
 namespace Real::math {
     bool DecomposeTransform(const glm::mat4 &transform, glm::vec3& translation, glm::quat &rotation, glm::vec3 &scale);
     int FindMax(int firstNum, int secondNum);
     [[nodiscard]] int FindClosestPowerOfTwo(int num);
+    [[nodiscard]] AABB ComputeAABB(std::span<const Vertex> vertices);
+    [[nodiscard]] AABB ToAABB(const MeshBinaryHeader& header);
+    void WriteAABB(const AABB& bounds, MeshBinaryHeader& header);
+
+    // Octahedral unit vector <-> [-1, 1]^2
+    [[nodiscard]] glm::vec2 OctEncode(const glm::vec3& n);
+    [[nodiscard]] glm::vec3 OctDecode(const glm::vec2& e);
+    // Positions are quantized inside the bounds, main.vert decodes them with the same bounds
+    [[nodiscard]] PackedVertex PackVertex(const Vertex& v, const AABB& bounds);
+    [[nodiscard]] Vertex UnpackVertex(const PackedVertex& v, const AABB& bounds);
+    [[nodiscard]] std::vector<PackedVertex> PackVertices(std::span<const Vertex> vertices, const AABB& bounds);
 }
\ No newline at end of file
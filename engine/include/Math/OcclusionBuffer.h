@@ -0,0 +1,68 @@
+//
+// Created by pointerlost on 1/15/26.
+//
+#pragma once
+#include <functional>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Common/RealTypes.h"
+#include "Core/RealConfig.h"
+
+namespace Real::math {
+
+    // Low resolution depth buffer for the CPU occlusion culling (masked occlusion style, software rasterized)
+    // Occluders are written with the farthest depth of each triangle at the covered pixel centers (watertight like the GPU),
+    // tested boxes are grown by a pixel to stay conservative. Pure CPU, no GL, the same input always gives the same buffer
+    class OcclusionBuffer {
+    public:
+        // Runs func over [0, count) in chunks (the job system's ParallelFor), serial when empty
+        using TileRunner = std::function<void(size_t count, const std::function<void(size_t begin, size_t end)>& func)>;
+
+        // Rounded up to whole tiles
+        explicit OcclusionBuffer(uint32_t width = OCCLUSION_BUFFER_WIDTH, uint32_t height = OCCLUSION_BUFFER_HEIGHT);
+
+        // Clears the depth and the occluders of the last frame
+        void Begin(const glm::mat4& viewProjection);
+        // Local space triangles, binned per tile. Triangles crossing the near plane are skipped
+        void AddOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::mat4& model);
+        // Tiles don't share anything, they can run on any thread in any order
+        void Rasterize(const TileRunner& runner = {});
+
+        // Local space box, false only if it's completely behind the occluders
+        [[nodiscard]] bool IsVisible(const AABB& bounds, const glm::mat4& model) const;
+
+        [[nodiscard]] uint32_t GetWidth() const { return m_Width; }
+        [[nodiscard]] uint32_t GetHeight() const { return m_Height; }
+        // [0, 1], 1 where nothing is rasterized. y goes up like the GL window coordinates
+        [[nodiscard]] float GetDepth(uint32_t x, uint32_t y) const { return m_Depth[y * m_Width + x]; }
+        [[nodiscard]] size_t GetTriangleCount() const { return m_Triangles.size(); }
+
+        // SSE rasterization when it's compiled in, off = the scalar path (same buffer, the tests compare them)
+        void SetSIMD(bool enabled) { m_SIMD = enabled && HasSIMD(); }
+        [[nodiscard]] static bool HasSIMD();
+
+    private:
+        // Edge functions are A * x + B * y + C, >= 0 inside
+        struct ScreenTriangle {
+            float m_A[3], m_B[3], m_C[3];
+            float m_MaxDepth;
+            int m_MinX, m_MinY, m_MaxX, m_MaxY; // Pixel bounds, inclusive
+        };
+
+        uint32_t m_Width;
+        uint32_t m_Height;
+        uint32_t m_TilesX;
+        uint32_t m_TilesY;
+        bool m_SIMD = HasSIMD();
+        glm::mat4 m_ViewProjection{1.0f};
+        std::vector<float> m_Depth;
+        std::vector<float> m_TileMaxDepth; // Farthest depth of every tile, most of the tests stop here
+        std::vector<ScreenTriangle> m_Triangles;
+        std::vector<std::vector<uint32_t>> m_TileBins; // Triangles overlapping each tile
+
+    private:
+        void RasterizeTile(uint32_t tile);
+        [[nodiscard]] bool IsRectVisible(int minX, int minY, int maxX, int maxY, float minDepth) const;
+    };
+}
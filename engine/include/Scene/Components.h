@@ -2,10 +2,12 @@
 // Created by pointerlost on 10/8/25.
 //
 #pragma once
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include "Core/Utils.h"
 #include "Core/UUID.h"
+#include "Common/RealTypes.h"
 #include "Graphics/Camera.h"
 #include "Graphics/Light.h"
 #include "Graphics/Transformations.h"
@@ -16,7 +18,10 @@ namespace Real {
 }
 
 namespace Real {
-    // TODO: Add dirty flags to manage components and avoid to unnecessary updates
+    // TODO: Add dirty flags to the other components too (only transforms have one for now)
+
+    // No slot in the GPU buffers yet
+    constexpr uint32_t INVALID_GPU_SLOT = UINT32_MAX;
 
     struct TagComponent {
         std::string m_Tag{};
@@ -35,6 +40,7 @@ namespace Real {
 
     struct TransformComponent {
         Transformations m_Transform{};
+        uint32_t m_GPUSlot = INVALID_GPU_SLOT; // Persistent index in the transform SSBO (owned by RenderContext)
         TransformComponent() = default;
         TransformComponent(const TransformComponent&) = delete;
     };
@@ -51,6 +57,10 @@ namespace Real {
     struct MeshRendererComponent {
         std::vector<UUID> m_MeshUUIDs = {};
         std::vector<UUID> m_MaterialInstanceUUIDs = {};
+        // Resolved from the UUIDs on the render extraction, again when the mesh manager version changes
+        std::vector<MeshHandle> m_MeshHandles = {};
+        std::vector<MaterialHandle> m_MaterialHandles = {};
+        uint64_t m_HandleVersion = 0;
         MeshRendererComponent(const std::vector<UUID>& meshUUIDs, const std::vector<UUID>& matInstanceUUIDs)
             : m_MeshUUIDs(meshUUIDs), m_MaterialInstanceUUIDs(matInstanceUUIDs) {}
         MeshRendererComponent(const UUID& meshUUID, const UUID& matInstanceUUID)
@@ -21,6 +21,12 @@ namespace Real {
 
 namespace Real {
 
+    // Renderer options which go with the scene
+    struct SceneRenderSettings {
+        // Two phase Hi-Z on the GPU culling path, software rasterized occluders on the CPU one
+        bool m_OcclusionCulling = false;
+    };
+
     class Scene {
     public:
         Scene();
@@ -47,8 +53,12 @@ namespace Real {
         template <typename T>
         void OnComponentAdded(Entity& entity, T& component);
 
+        SceneRenderSettings& GetRenderSettings() { return m_RenderSettings; }
+        [[nodiscard]] const SceneRenderSettings& GetRenderSettings() const { return m_RenderSettings; }
+
     private:
         entt::registry m_Registry;
         std::unordered_map<UUID, Entity> m_Entities;
+        SceneRenderSettings m_RenderSettings;
     };
 }
@@ -8,21 +8,26 @@ namespace Real {
 
     class TransformUpdate final : public Systems {
         void Update(Scene *scene, float deltaTime) override;
+        [[nodiscard]] SystemAccess GetAccess() const override;
     };
 
     class VelocityUpdate final : public  Systems {
         void Update(Scene *scene, float deltaTime) override;
+        [[nodiscard]] SystemAccess GetAccess() const override;
     };
 
     class MeshRendererUpdate final : public Systems {
         void Update(Scene *scene, float deltaTime) override;
+        [[nodiscard]] SystemAccess GetAccess() const override;
     };
 
     class CameraUpdate final : public Systems {
         void Update(Scene *scene, float deltaTime) override;
+        [[nodiscard]] SystemAccess GetAccess() const override;
     };
 
     class LightUpdate final : public Systems {
         void Update(Scene *scene, float deltaTime) override;
+        [[nodiscard]] SystemAccess GetAccess() const override;
     };
-}
\ No newline at end of file
+}
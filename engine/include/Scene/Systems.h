@@ -3,15 +3,45 @@
 //
 #pragma once
 #include <vector>
+#include <entt/entt.hpp>
 #include "Core/Utils.h"
 
 namespace Real { class Scene; }
 
 namespace Real {
 
+    // Which components a system touches, the scheduler runs the non-conflicting ones together
+    struct SystemAccess {
+        std::vector<entt::id_type> m_Reads;
+        std::vector<entt::id_type> m_Writes;
+        bool m_Exclusive = false; // Unknown access, conflicts with everything
+
+        template <typename... Components>
+        SystemAccess& Read() {
+            (m_Reads.push_back(entt::type_hash<Components>::value()), ...);
+            return *this;
+        }
+
+        template <typename... Components>
+        SystemAccess& Write() {
+            (m_Writes.push_back(entt::type_hash<Components>::value()), ...);
+            return *this;
+        }
+
+        static SystemAccess Exclusive() {
+            SystemAccess access;
+            access.m_Exclusive = true;
+            return access;
+        }
+
+        [[nodiscard]] bool ConflictsWith(const SystemAccess& other) const;
+    };
+
     struct ISystem {
         virtual ~ISystem() = default;
         virtual void Update(Scene* scene, float deltaTime) = 0;
+        // Systems which don't declare their access run alone
+        [[nodiscard]] virtual SystemAccess GetAccess() const { return SystemAccess::Exclusive(); }
     };
 
     class Systems : public ISystem {
@@ -24,6 +54,11 @@ namespace Real {
 
     private:
         std::vector<Scope<Systems>> m_Updatables;
+        // Indices of the earlier systems each system has to wait (built once in Init)
+        std::vector<std::vector<size_t>> m_Dependencies;
+
+    private:
+        void BuildDependencyGraph();
     };
 
 }
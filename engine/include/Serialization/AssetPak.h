@@ -0,0 +1,76 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#pragma once
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "Common/Macros.h"
+#include "Common/RealTypes.h"
+#include "Core/file_manager.h"
+
+namespace Real::serialization {
+
+    // All the mesh binaries (+ meshlets) in one file, packed from the loose .mesh files
+    // Layout: [header][payloads, ASSET_PAK_ALIGNMENT aligned][table of contents sorted by UUID]
+    // Payloads are used straight from the mapped file, the mesh manager copies them once into its pools
+
+    // Bump it when the layout changes (mesh binary header too), old paks are packed again
+    constexpr uint32_t ASSET_PAK_VERSION = 2;
+    constexpr uint32_t ASSET_PAK_FOURCC = MakeFourCC('R', 'P', 'A', 'K');
+    constexpr uint64_t ASSET_PAK_ALIGNMENT = 64;
+
+#pragma pack(push, 1)
+    struct AssetPakHeader {
+        uint32_t m_Magic   = REAL_MAGIC;
+        uint32_t m_FourCC  = ASSET_PAK_FOURCC;
+        uint32_t m_Version = ASSET_PAK_VERSION;
+        uint32_t m_MeshCount{};
+        uint64_t m_TOCOffset{};
+        uint64_t m_FileSize{}; // Truncated files are rejected
+    };
+
+    struct AssetPakMeshEntry {
+        MeshBinaryHeader m_Header; // Always COMPACT and uncompressed, the loose binaries are converted while building
+        // Offsets from the start of the file
+        uint64_t m_VertexData{};
+        uint64_t m_IndexData{};
+        uint64_t m_MeshletData{};
+        uint64_t m_MeshletCount{};
+    };
+#pragma pack(pop)
+
+    // Views into the mapped file, valid until the pak is closed
+    struct PakMesh {
+        const MeshBinaryHeader* m_Header = nullptr;
+        std::span<const PackedVertex> m_Vertices;
+        std::span<const uint32_t> m_Indices;
+        std::span<const Meshlet> m_Meshlets;
+    };
+
+    // A mesh going into the pak, the loose binary is only read if the previous pak doesn't have it
+    struct PakMeshSource {
+        uint64_t m_UUID{};
+        std::string m_Binary;
+    };
+
+    class AssetPak {
+    public:
+        // Through a temporary file, previous is closed right before it's replaced
+        static bool Build(const std::string& path, std::span<const PakMeshSource> meshes, AssetPak& previous);
+
+        // False if the file is missing or broken
+        bool Open(const std::string& path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_Header != nullptr; }
+        [[nodiscard]] size_t GetMeshCount() const { return m_Header ? m_Header->m_MeshCount : 0; }
+        [[nodiscard]] std::optional<PakMesh> FindMesh(uint64_t uuid) const;
+
+    private:
+        fs::MappedFile m_File;
+        const AssetPakHeader* m_Header = nullptr;
+        const AssetPakMeshEntry* m_TOC = nullptr;
+    };
+}
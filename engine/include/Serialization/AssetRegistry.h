@@ -0,0 +1,145 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#pragma once
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "Common/Macros.h"
+#include "Core/file_manager.h"
+
+namespace Real::serialization {
+
+    // Compiled form of the asset database, asset_database.json stays the editable source
+    // Fixed size records + a string pool + lookup tables, used straight from the mapped file (no parsing at startup)
+    // Layout: [header][records][uuid index][source index][path table][name table][string pool]
+
+    // Bump it when the layout changes, old files are recompiled from the JSON
+    // Version 2 adds the source path/hash of the cooked assets, version 3 the import settings key
+    constexpr uint32_t ASSET_REGISTRY_VERSION = 3;
+    constexpr uint32_t ASSET_REGISTRY_FOURCC = MakeFourCC('A', 'R', 'E', 'G');
+
+    // Records are grouped in this order, same as the import order
+    enum class AssetKind : uint32_t {
+        TEXTURE,
+        MATERIAL,
+        MESH,
+        MODEL,
+        COUNT
+    };
+
+    // AssetRecord::m_Flags
+    constexpr uint32_t ASSET_RECORD_HAS_TEXTURES = 1 << 0; // Material has the "textures" object
+
+#pragma pack(push, 1)
+    struct AssetString {
+        uint32_t m_Offset{}; // Into the string pool
+        uint32_t m_Length{};
+    };
+
+    struct AssetRecord {
+        uint64_t m_UUID{};
+        AssetKind m_Kind = AssetKind::TEXTURE;
+        uint32_t m_TextureType{}; // TextureType, textures only
+        uint32_t m_FormatState{}; // ImageFormatState, textures only
+        uint32_t m_Flags{};
+
+        AssetString m_Key;       // Importer cache key, path for textures/meshes/models and name for materials
+        AssetString m_Name;      // Engine asset name (the file name for textures)
+        AssetString m_FileName;  // Models only
+        AssetString m_Stem;
+        AssetString m_Path;
+        AssetString m_Extension;
+        AssetString m_Binary;    // Runtime binary of the meshes/models
+        AssetString m_SourcePath; // Textures only, the file it was cooked from (path is the cooked one)
+
+        // Content + import settings hash of the source, 0 if it's unknown (older imports)
+        uint64_t m_SourceHash{};
+        uint64_t m_SourceStamp{}; // Size + write time of the source when it was hashed
+        uint64_t m_SourceSettings{}; // Import settings it was cooked with, hashed again when they change
+
+        // Materials only: albedo, normal, orm, height, emissive
+        uint64_t m_Textures[5]{};
+    };
+
+    // Sorted by the key (UUID or source hash)
+    struct AssetIndexEntry {
+        uint64_t m_Key{};
+        uint32_t m_Record{};
+    };
+
+    struct AssetRegistryHeader {
+        uint32_t m_Magic   = REAL_MAGIC;
+        uint32_t m_FourCC  = ASSET_REGISTRY_FOURCC;
+        uint32_t m_Version = ASSET_REGISTRY_VERSION;
+        uint32_t m_RecordCount{};
+        uint32_t m_SourceCount{}; // Records with a source hash
+        uint32_t m_Padding{};
+
+        // The JSON it was compiled from, a different one means the registry is stale
+        uint64_t m_SourceSize{};
+        int64_t  m_SourceTime{};
+
+        uint32_t m_KindBegin[static_cast<uint32_t>(AssetKind::COUNT) + 1]{}; // Record ranges per kind
+        uint32_t m_TableCapacity{}; // Slots of the path and the name tables (power of two)
+
+        uint64_t m_RecordOffset{};
+        uint64_t m_UUIDIndexOffset{};
+        uint64_t m_SourceIndexOffset{};
+        uint64_t m_PathTableOffset{};
+        uint64_t m_NameTableOffset{};
+        uint64_t m_StringOffset{};
+        uint64_t m_StringSize{};
+    };
+#pragma pack(pop)
+
+    class AssetRegistry {
+    public:
+        // Size and write time of the JSON
+        struct SourceStamp {
+            uint64_t m_Size = 0;
+            int64_t m_Time = 0;
+        };
+        [[nodiscard]] static SourceStamp GetSourceStamp(const std::string& jsonPath);
+
+        // The whole registry file of the DB json
+        [[nodiscard]] static std::vector<uint8_t> Compile(const nlohmann::json& db, const SourceStamp& source);
+        // Through a temporary file, the old registry stays intact if it fails
+        static bool Write(const std::string& path, std::span<const uint8_t> registry);
+
+        // False if the file is missing, broken or compiled from another JSON
+        bool Open(const std::string& path, const SourceStamp& source);
+        // Keeps a compiled registry in memory, when it can't be written next to the JSON
+        bool Open(std::vector<uint8_t> registry, const SourceStamp& source);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_Header != nullptr; }
+        [[nodiscard]] size_t GetRecordCount() const { return m_Header ? m_Header->m_RecordCount : 0; }
+        [[nodiscard]] std::span<const AssetRecord> GetRecords(AssetKind kind) const;
+        [[nodiscard]] std::string_view GetString(const AssetString& str) const;
+
+        // nullptr if there is no such asset
+        [[nodiscard]] const AssetRecord* FindByUUID(uint64_t uuid) const;
+        [[nodiscard]] const AssetRecord* FindByPath(std::string_view path) const;
+        [[nodiscard]] const AssetRecord* FindByName(std::string_view name) const;
+        // Any record of the kind cooked from the same content and settings
+        [[nodiscard]] const AssetRecord* FindBySourceHash(uint64_t hash, AssetKind kind) const;
+
+    private:
+        fs::MappedFile m_File;
+        std::vector<uint8_t> m_Memory;
+        const AssetRegistryHeader* m_Header = nullptr;
+        const AssetRecord* m_Records = nullptr;
+        const AssetIndexEntry* m_UUIDIndex = nullptr;
+        const AssetIndexEntry* m_SourceIndex = nullptr;
+        const uint32_t* m_PathTable = nullptr;
+        const uint32_t* m_NameTable = nullptr;
+        const char* m_Strings = nullptr;
+
+    private:
+        bool Attach(const uint8_t* data, size_t size, const SourceStamp& source);
+        [[nodiscard]] const AssetRecord* FindInTable(const uint32_t* table, std::string_view key) const;
+    };
+}
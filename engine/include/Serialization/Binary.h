@@ -2,9 +2,11 @@
 // Created by pointerlost on 12/15/25.
 //
 #pragma once
+#include <span>
 #include <string>
 #include <vector>
 #include "Common/RealTypes.h"
+#include "Core/RealConfig.h"
 #include "Core/Utils.h"
 
 namespace Real::serialization::binary {
@@ -17,8 +19,28 @@ namespace Real::serialization::binary {
     [[maybe_unused]] std::tuple<ModelBinaryHeader, std::vector<UUID>, std::vector<UUID>> LoadModel(const std::string& path);
 
     /* ********************************************* MESH STATE ********************************************* */
+    // Payloads are zstd compressed when compress is on (MESH_BINARY_COMPRESSION), LoadMesh reads every version
     void WriteMesh(const std::string& path, const MeshBinaryHeader &binaryHeader,
-        const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices
+        const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool compress = MESH_BINARY_COMPRESSION
+    );
+    // Compact binaries, the vertices are packed against the header bounds
+    void WriteMesh(const std::string& path, const MeshBinaryHeader &binaryHeader,
+        std::span<const PackedVertex> vertices, const std::vector<uint32_t>& indices, bool compress = MESH_BINARY_COMPRESSION
     );
     [[maybe_unused]] MeshLoadResult LoadMesh(const std::string& path);
+
+    // Shared zstd dictionary of the small mesh payloads (runtime/meshes/meshes.zdict), loaded on first use
+    [[nodiscard]] bool HasMeshDictionary();
+    // Tests and tools can point it somewhere else, only before the dictionary is used for the first time
+    bool SetMeshDictionaryPath(const std::string& path);
+    // Only if there isn't one yet, the binaries written with it can't be read without it
+    // Samples are raw payloads (packed vertices + indices) of small meshes
+    bool TrainMeshDictionary(std::span<const std::vector<uint8_t>> samples);
+
+    /* ********************************************* MESHLET STATE ********************************************* */
+    // Path of the meshlet file next to a mesh binary
+    [[nodiscard]] std::string MeshletPath(const std::string& meshBinaryPath);
+    void WriteMeshlets(const std::string& path, const UUID& meshUUID, std::span<const Meshlet> meshlets);
+    // Empty if the mesh has no meshlet file (small meshes or older imports)
+    [[nodiscard]] std::vector<Meshlet> LoadMeshlets(const std::string& path);
 }
@@ -6,6 +6,7 @@
 #include <nlohmann/json.hpp>
 
 namespace Real::serialization::json {
-    void Save(const std::string& path, const nlohmann::json& j);
+    // False if the file couldn't be written
+    bool Save(const std::string& path, const nlohmann::json& j);
     nlohmann::json Load(const std::string& path);
 }
@@ -11,6 +11,8 @@ namespace Real {
 }
 
 namespace Real::tools {
+    // Thread-safe, compress functions call it by themselves
+    void InitCompressonator();
     Ref<OpenGLTexture> PackTexturesToRGBChannels(const Ref<OpenGLTexture>& ao, const Ref<OpenGLTexture>& rgh,
         const Ref<OpenGLTexture>& mtl, const std::string& materialName
     );
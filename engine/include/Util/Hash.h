@@ -0,0 +1,17 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Real::util {
+
+    // XXH64, same result on every platform (little endian reads), used as the content hash of the asset sources
+    [[nodiscard]] uint64_t XXH64(const void* data, size_t size, uint64_t seed = 0);
+    // Whole file through a mapped view, false if it can't be opened (empty files hash as empty input)
+    bool TryHashFile(const std::string& path, uint64_t& hash, uint64_t seed = 0);
+    // Size + write time of a file, 0 if it doesn't exist. Cheap check before hashing the content again
+    [[nodiscard]] uint64_t HashFileStamp(const std::string& path);
+}
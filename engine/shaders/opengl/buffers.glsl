@@ -154,9 +154,9 @@ TexturePack GetTexturePack(int materialIndex, vec2 UV) {
 }
 
 struct Light {
-    vec4 pos_cutoff; // vec3 position,  w = cutOff
-    vec4 dir_outer;  // vec3 direction, w = outerCutOff
-    vec4 radiance;   // vec3 radiance,  w = unused
+    vec4 pos_cutoff; // vec3 position,  w = cos(cutOff)
+    vec4 dir_outer;  // vec3 direction, w = cos(outerCutOff)
+    vec4 radiance;   // vec3 radiance,  w = range
     int type; // point = 0, directional = 1, spot = 2
     // Attenuation parameters
     float constant;
@@ -194,18 +194,60 @@ struct EntityData {
     int materialIndex;
     int indexCount;
     int indexOffset;
+    int meshIndex;
 };
 layout (std430, binding = 1) buffer EntityMetaData {
     EntityData entityData[];
 };
 
+// Per mesh data, the universal VBO holds positions normalized inside the mesh bounds
+struct MeshData {
+    vec4 boundsMin;    // w unused
+    vec4 boundsExtent; // w unused
+};
+layout (std430, binding = 8) buffer MeshTableSSBO {
+    MeshData meshes[];
+};
+
+vec3 DecodePosition(int meshIdx, vec3 quantized) {
+    return meshes[meshIdx].boundsMin.xyz + quantized * meshes[meshIdx].boundsExtent.xyz;
+}
+
 // Global Data
 layout(std140, binding = 7) uniform GlobalDataUBO {
     vec4 GlobalAmbient; // last index padding
-    int lightCount[4]; // 0 = lightCount, other indices padding
+    ivec4 lightCount; // x = lightCount, other indices padding (an int[4] would be 64 bytes in std140)
+    uvec4 clusterGrid; // xyz = cluster counts
+    vec4 clusterDepth; // x = near, y = far, z = log(far / near)
 } uGlobalData;
 
 vec3 GetGlobalAmbient() { return uGlobalData.GlobalAmbient.xyz; }
-int GetLightCount() { return uGlobalData.lightCount[0]; }
+int GetLightCount() { return uGlobalData.lightCount.x; }
+
+// Clustered lighting, filled by LightGrid
+struct LightCluster {
+    uint offset;
+    uint count;
+};
+layout(std430, binding = 15) buffer LightClusterSSBO {
+    LightCluster lightClusters[];
+};
+layout(std430, binding = 16) buffer LightIndexSSBO {
+    uint lightIndices[];
+};
+
+// Screen tile from the clip position, exponential depth slice from the view depth
+uint GetClusterIndex(vec3 worldPos) {
+    uvec3 grid = uGlobalData.clusterGrid.xyz;
+    vec4 clip = GetProjView() * vec4(worldPos, 1.0);
+    vec2 tile = clamp((clip.xy / clip.w * 0.5 + 0.5) * vec2(grid.xy), vec2(0.0), vec2(grid.xy) - 1.0);
+
+    float depth = -(GetView() * vec4(worldPos, 1.0)).z;
+    float zNear = uGlobalData.clusterDepth.x;
+    float slice = log(max(depth, zNear) / zNear) / uGlobalData.clusterDepth.z * float(grid.z);
+    uint z = uint(clamp(slice, 0.0, float(grid.z) - 1.0));
+
+    return uint(tile.x) + uint(tile.y) * grid.x + z * grid.x * grid.y;
+}
 
 #endif
\ No newline at end of file
@@ -123,8 +123,8 @@ vec3 CalculatePBR(Light light, PerVertexData pvd, vec3 N, vec3 F0, TexturePack t
         vec3 L = normalize(lightPos - fragPos);
         float distance = length(lightPos - fragPos);
 
-        // Range check
-        if (distance > light.dir_outer.w) {
+        // Range check, the light grid is built with the same range
+        if (distance > light.radiance.w) {
             return vec3(0.0);
         }
 
@@ -143,8 +143,9 @@ vec3 CalculatePBR(Light light, PerVertexData pvd, vec3 N, vec3 F0, TexturePack t
         vec3 L = normalize(lightPos - fragPos);
         vec3 lightDirNorm = normalize(lightDir);
 
-        float cutOff      = cos(radians(light.pos_cutoff.w));      // Inner cutoff
-        float outerCutOff = cos(radians(light.dir_outer.w));       // Outer cutoff
+        // Already cosines (Light::ConvertToGPUFormat)
+        float cutOff      = light.pos_cutoff.w; // Inner cutoff
+        float outerCutOff = light.dir_outer.w;  // Outer cutoff
 
         float theta = dot(-L, lightDirNorm);  // Angle between light direction and fragment
         float epsilon = cutOff - outerCutOff;
@@ -156,6 +157,9 @@ vec3 CalculatePBR(Light light, PerVertexData pvd, vec3 N, vec3 F0, TexturePack t
         }
 
         float distance = length(lightPos - fragPos);
+        if (distance > light.radiance.w) {
+            return vec3(0.0);
+        }
         float attenuation = 1.0 / (light.constant +
                                    light.linear * distance +
                                    light.quadratic * (distance * distance));
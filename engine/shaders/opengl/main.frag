@@ -45,11 +45,11 @@ void main() {
     vec3 V  = normalize(GetViewPos() - fs_in.FragPos);
     vec3 F0 = mix(vec3(0.04), tp.albedo, tp.metallic);
 
-    // Direct lighting
+    // Direct lighting, only the lights of the fragment's cluster
     vec3 Lo = vec3(0.0);
-    int lightCount = GetLightCount();
-    for (int i = 0; i < lightCount; i++) {
-        Lo += CalculatePBR(lights[i], pvd, N, F0, tp);
+    LightCluster cluster = lightClusters[GetClusterIndex(fs_in.FragPos)];
+    for (uint i = 0u; i < cluster.count; i++) {
+        Lo += CalculatePBR(lights[lightIndices[cluster.offset + i]], pvd, N, F0, tp);
     }
 
     // Ambient lighting - FIXED
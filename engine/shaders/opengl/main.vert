@@ -3,11 +3,13 @@
 #extension GL_ARB_gpu_shader_int64 : enable
 #extension GL_NV_gpu_shader5 : enable
 
+#include "opengl/utils.glsl"
 #include "opengl/buffers.glsl"
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aUV;
+// PackedVertex, see MeshData::InitResources
+layout (location = 0) in vec3 aPos;    // unorm16 inside the mesh bounds
+layout (location = 1) in vec2 aNormal; // Octahedral snorm16
+layout (location = 2) in vec2 aUV;     // half2
 
 out VS_OUT {
     vec3 FragPos;
@@ -17,15 +19,19 @@ out VS_OUT {
 } vs_out;
 
 void main() {
-    int entityIdx = gl_DrawID;
+    // One entry per instance, the batch instances start at the command's baseInstance
+    int entityIdx = gl_BaseInstance + gl_InstanceID;
     EntityData entityProps = entityData[entityIdx];
 
     int transformIdx = entityProps.transformIndex;
 
+    vec3 localPos = DecodePosition(entityProps.meshIndex, aPos);
+    vec3 normal = OctDecode(aNormal);
+
     vs_out.MaterialIndex = entityProps.materialIndex;
-    vs_out.FragPos = vec3(GetModelMatrix(transformIdx) * vec4(aPos, 1.0));
-    vs_out.Normal = normalize(GetNormalMatrix(transformIdx) * aNormal);
+    vs_out.FragPos = vec3(GetModelMatrix(transformIdx) * vec4(localPos, 1.0));
+    vs_out.Normal = normalize(GetNormalMatrix(transformIdx) * normal);
     vs_out.UV = aUV;
 
-    gl_Position = GetProjView() * GetModelMatrix(transformIdx) * vec4(aPos, 1.0f);
+    gl_Position = GetProjView() * vec4(vs_out.FragPos, 1.0f);
 }
\ No newline at end of file
@@ -13,4 +13,12 @@ vec3 Convert_LinearSpace_to_sRGB(vec3 content) {
     return pow(content, vec3(1.0 / gamma));
 }
 
+// Octahedral [-1, 1]^2 -> unit vector, matches math::OctDecode
+vec3 OctDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+//
+// Created by pointerlost on 1/6/26.
+//
+#include "Common/Scheduling/TaskManager.h"
+#include <algorithm>
+#include <exception>
+#include <format>
+#include "Core/Logger.h"
+
+namespace {
+    // -1 = not a worker (main thread or foreign thread)
+    thread_local int s_WorkerIndex = -1;
+}
+
+namespace Real {
+
+    TaskManager::TaskManager(uint32_t workerCount) {
+        if (workerCount == 0) {
+            const uint32_t hardware = std::thread::hardware_concurrency();
+            // Leave one core to the main thread, it helps while waiting anyway
+            workerCount = hardware > 1 ? hardware - 1 : 1;
+        }
+
+        m_Queues.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Queues.push_back(CreateScope<WorkerQueue>());
+        }
+
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&TaskManager::WorkerLoop, this, i);
+        }
+        Info(std::format("TaskManager started with {} workers", workerCount));
+    }
+
+    TaskManager::~TaskManager() {
+        {
+            std::lock_guard lock(m_SleepMutex);
+            m_Running = false;
+        }
+        m_SleepCV.notify_all();
+
+        for (auto& worker : m_Workers) {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    JobHandle TaskManager::Submit(Job job) {
+        auto counter = CreateRef<JobCounter>();
+        counter->m_Pending = 1;
+        Push({ std::move(job), counter });
+        return counter;
+    }
+
+    JobHandle TaskManager::Submit(Job job, const JobHandle &dependency) {
+        return Submit(std::move(job), std::vector{ dependency });
+    }
+
+    JobHandle TaskManager::Submit(Job job, const std::vector<JobHandle> &dependencies) {
+        auto counter = CreateRef<JobCounter>();
+        counter->m_Pending = 1;
+
+        std::vector<JobHandle> pending;
+        pending.reserve(dependencies.size());
+        for (const auto& dep : dependencies) {
+            if (!dep) continue;
+            if (!IsDone(dep))
+                pending.push_back(dep);
+            else if (dep->m_Failed.load(std::memory_order_acquire))
+                Fail(counter, dep->m_Exception);
+        }
+
+        if (pending.empty()) {
+            Push({ std::move(job), counter });
+            return counter;
+        }
+
+        // Last finished dependency pushes the job
+        auto gate  = CreateRef<std::atomic<int>>(static_cast<int>(pending.size()));
+        auto entry = CreateRef<JobEntry>(JobEntry{ std::move(job), counter });
+        for (const auto& dep : pending) {
+            AddContinuation(dep, [this, gate, entry, dep] {
+                // A failed dependency fails the job too, Execute skips it
+                if (dep->m_Failed.load(std::memory_order_acquire))
+                    Fail(entry->m_Counter, dep->m_Exception);
+                if (gate->fetch_sub(1) == 1)
+                    Push(std::move(*entry));
+            });
+        }
+        return counter;
+    }
+
+    void TaskManager::Wait(const JobHandle &handle) {
+        if (!handle) return;
+
+        while (!IsDone(handle)) {
+            if (RunOneJob())
+                continue;
+
+            // Nothing to steal, sleep until a new job shows up or the handle is done
+            std::unique_lock lock(m_SleepMutex);
+            m_SleepCV.wait(lock, [&] {
+                return IsDone(handle) || m_QueuedJobs.load() > 0;
+            });
+        }
+
+        if (handle->m_Failed.load(std::memory_order_acquire))
+            std::rethrow_exception(handle->m_Exception);
+    }
+
+    void TaskManager::WaitAll(const std::vector<JobHandle> &handles) {
+        for (const auto& handle : handles) {
+            Wait(handle);
+        }
+    }
+
+    bool TaskManager::IsDone(const JobHandle &handle) {
+        return !handle || handle->m_Done.load(std::memory_order_acquire);
+    }
+
+    void TaskManager::ParallelFor(size_t count, const std::function<void(size_t, size_t)> &func, size_t grainSize) {
+        if (count == 0) return;
+
+        if (grainSize == 0) {
+            // A few chunks per worker so the stealing can balance uneven work
+            const size_t chunks = (m_Workers.size() + 1) * 4;
+            grainSize = std::max<size_t>(1, (count + chunks - 1) / chunks);
+        }
+
+        const size_t chunkCount = (count + grainSize - 1) / grainSize;
+        if (chunkCount == 1) {
+            func(0, count);
+            return;
+        }
+
+        auto counter = CreateRef<JobCounter>();
+        counter->m_Pending = static_cast<int>(chunkCount);
+
+        // Caller thread takes the first chunk itself
+        for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+            const size_t begin = chunk * grainSize;
+            const size_t end   = std::min(begin + grainSize, count);
+            Push({ [&func, begin, end] { func(begin, end); }, counter });
+        }
+
+        JobEntry first{ [&func, grainSize] { func(0, grainSize); }, counter };
+        Execute(first);
+
+        Wait(counter);
+    }
+
+    bool TaskManager::IsWorkerThread() {
+        return s_WorkerIndex >= 0;
+    }
+
+    void TaskManager::WorkerLoop(uint32_t workerIndex) {
+        s_WorkerIndex = static_cast<int>(workerIndex);
+
+        while (true) {
+            if (RunOneJob())
+                continue;
+
+            std::unique_lock lock(m_SleepMutex);
+            m_SleepCV.wait(lock, [&] {
+                return !m_Running.load() || m_QueuedJobs.load() > 0;
+            });
+            if (!m_Running.load())
+                break;
+        }
+    }
+
+    void TaskManager::Push(JobEntry entry) {
+        uint32_t index;
+        if (s_WorkerIndex >= 0) {
+            // Workers keep their own jobs local, others will steal if they are idle
+            index = static_cast<uint32_t>(s_WorkerIndex);
+        } else {
+            index = m_NextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(m_Queues.size());
+        }
+
+        {
+            auto& queue = *m_Queues[index];
+            std::lock_guard lock(queue.m_Mutex);
+            queue.m_Jobs.push_back(std::move(entry));
+        }
+        m_QueuedJobs.fetch_add(1);
+        WakeSleepers(false);
+    }
+
+    bool TaskManager::TryPop(JobEntry &out) {
+        const auto queueCount = static_cast<uint32_t>(m_Queues.size());
+
+        // Own queue first (LIFO, it's still hot in the cache)
+        if (s_WorkerIndex >= 0) {
+            auto& own = *m_Queues[s_WorkerIndex];
+            std::lock_guard lock(own.m_Mutex);
+            if (!own.m_Jobs.empty()) {
+                out = std::move(own.m_Jobs.back());
+                own.m_Jobs.pop_back();
+                m_QueuedJobs.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // Steal the oldest job from the others
+        const uint32_t start = s_WorkerIndex >= 0 ? static_cast<uint32_t>(s_WorkerIndex) + 1 : 0;
+        for (uint32_t i = 0; i < queueCount; i++) {
+            auto& victim = *m_Queues[(start + i) % queueCount];
+            std::lock_guard lock(victim.m_Mutex);
+            if (!victim.m_Jobs.empty()) {
+                out = std::move(victim.m_Jobs.front());
+                victim.m_Jobs.pop_front();
+                m_QueuedJobs.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TaskManager::RunOneJob() {
+        JobEntry entry;
+        if (!TryPop(entry))
+            return false;
+
+        Execute(entry);
+        return true;
+    }
+
+    void TaskManager::Execute(JobEntry &entry) {
+        // Don't let a job kill the worker, the counter still has to reach zero and the waiter rethrows it
+        if (!entry.m_Counter || !entry.m_Counter->m_Failed.load(std::memory_order_acquire)) {
+            try {
+                entry.m_Job();
+            } catch (...) {
+                if (entry.m_Counter)
+                    Fail(entry.m_Counter, std::current_exception());
+                else
+                    Warn("Job threw an exception and nobody is waiting for it");
+            }
+        }
+
+        if (entry.m_Counter && entry.m_Counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Complete(entry.m_Counter);
+    }
+
+    void TaskManager::Complete(const JobHandle &counter) {
+        std::vector<Job> continuations;
+        {
+            std::lock_guard lock(counter->m_Mutex);
+            counter->m_Done.store(true, std::memory_order_release);
+            continuations.swap(counter->m_Continuations);
+        }
+
+        for (auto& continuation : continuations) {
+            continuation();
+        }
+
+        // Waiters are sleeping on the same condition variable
+        WakeSleepers(true);
+    }
+
+    void TaskManager::Fail(const JobHandle &counter, std::exception_ptr exception) {
+        std::lock_guard lock(counter->m_Mutex);
+        if (counter->m_Failed.load(std::memory_order_relaxed)) return; // Keep the first one
+
+        counter->m_Exception = std::move(exception);
+        counter->m_Failed.store(true, std::memory_order_release);
+    }
+
+    void TaskManager::AddContinuation(const JobHandle &dependency, Job continuation) {
+        {
+            std::lock_guard lock(dependency->m_Mutex);
+            if (!dependency->m_Done.load(std::memory_order_acquire)) {
+                dependency->m_Continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+        // Finished in the meantime
+        continuation();
+    }
+
+    void TaskManager::WakeSleepers(bool all) {
+        // Lock/unlock so a sleeper can't miss the notify between its check and wait
+        { std::lock_guard lock(m_SleepMutex); }
+        if (all)
+            m_SleepCV.notify_all();
+        else
+            m_SleepCV.notify_one();
+    }
+}
@@ -2,6 +2,11 @@
 // Created by pointerlost on 12/22/25.
 //
 #include <Core/AssetImporter.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "Common/Scheduling/TaskManager.h"
 
 #include "Core/AssetManager.h"
 #include "Core/file_manager.h"
@@ -9,16 +14,54 @@
 #include "Core/Services.h"
 #include "Graphics/Material.h"
 #include "Graphics/MeshManager.h"
+#include "Graphics/MeshOptimizer.h"
 #include "Graphics/Model.h"
+#include "Graphics/ModelLoader.h"
 #include "Graphics/Texture.h"
+#include "Math/Math.h"
 #include "Serialization/Binary.h"
 #include "Serialization/Json.h"
 #include "Tools/ImageTools.h"
+#include "Util/Hash.h"
 #include "Util/Util.h"
 
 namespace Real {
 
+    // Goes into the source hashes, bump it when the cooking changes (formats, quality) to compress everything again
+    static constexpr uint64_t TEXTURE_IMPORT_VERSION = 1;
+    static constexpr auto COMPRESSED_TEXTURE_DIR = ASSETS_DIR "textures/compressed/";
+
+    // Patch replacing/adding one entry of a DB section
+    static nlohmann::json EntryPatch(const char* section, const std::string& uuidStr, nlohmann::json entry) {
+        nlohmann::json patch;
+        patch[section][uuidStr] = std::move(entry);
+        return patch;
+    }
+
     AssetImporter::AssetImporter() {
+        std::error_code ec;
+        m_JournalSize = std::filesystem::file_size(ASSET_JOURNAL_PATH, ec);
+        if (ec) m_JournalSize = 0;
+
+        // Edits of the last session weren't folded into the JSON (crash), replay them and write a fresh snapshot
+        if (m_JournalSize > 0) {
+            LoadAssetDB();
+            CompactAssetDB(true);
+        }
+        OpenRegistry();
+    }
+
+    AssetImporter::~AssetImporter() {
+        FinishPakBuild();
+        AppendJournal();
+        FinishCompaction(true);
+        if (m_JournalSize > 0 || m_AssetDBDirty)
+            CompactAssetDB(true);
+    }
+
+    void AssetImporter::LoadAssetDB() {
+        if (m_AssetDBLoaded) return;
+        m_AssetDBLoaded = true;
         m_AssetDB = serialization::json::Load(ASSET_DB_PATH);
 
         if (!m_AssetDB.contains("textures") || !m_AssetDB["textures"].is_object())
@@ -33,10 +76,31 @@ namespace Real {
         if (!m_AssetDB.contains("models") || !m_AssetDB["models"].is_object())
             m_AssetDB["models"] = nlohmann::json::object();
 
-        BuildCachesFromDB();
+        ReplayJournal();
+    }
+
+    void AssetImporter::OpenRegistry() {
+        using serialization::AssetRegistry;
+        const auto start = std::chrono::steady_clock::now();
+        const auto source = AssetRegistry::GetSourceStamp(ASSET_DB_PATH);
+
+        if (!m_Registry.Open(ASSET_REGISTRY_PATH, source)) {
+            // Missing or older than the JSON, parse it once and compile again
+            LoadAssetDB();
+            auto registry = AssetRegistry::Compile(m_AssetDB, source);
+            if (!AssetRegistry::Write(ASSET_REGISTRY_PATH, registry) || !m_Registry.Open(ASSET_REGISTRY_PATH, source)) {
+                Warn("[AssetImporter] Asset registry can't be written, using it from memory");
+                m_Registry.Open(std::move(registry), source);
+            }
+        }
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[AssetImporter] Asset registry ready, {} assets in {:.1f} ms ({})",
+            m_Registry.GetRecordCount(), ms, m_AssetDBLoaded ? "compiled from JSON" : "mapped"));
     }
 
     nlohmann::json& AssetImporter::GetAssetDB() {
+        LoadAssetDB();
         return m_AssetDB;
     }
 
@@ -45,7 +109,7 @@ namespace Real {
             return;
 
         const std::string uuidStr = std::to_string(texture->GetUUID());
-        nlohmann::json& tex = m_AssetDB["textures"][uuidStr];
+        nlohmann::json tex;
 
         tex["name"]      = texture->GetName();
         tex["stem"]      = texture->GetStem();
@@ -53,9 +117,10 @@ namespace Real {
         tex["extension"] = texture->GetExtension();
         tex["type"]      = util::TextureType_EnumToString(texture->GetType());
         tex["image_format_state"] = util::ImageFormatState_EnumToString(texture->GetImageFormatState());
+        AddTextureSource(tex, texture->GetUUID());
 
         CacheAssetWithPath(texture->GetPath(), texture->GetUUID());
-        MarkDirtyAssetDB();
+        PatchAssetDB(EntryPatch("textures", uuidStr, std::move(tex)));
     }
 
     void AssetImporter::SaveMaterialToAssetDB(const Ref<Material> &mat) {
@@ -66,7 +131,7 @@ namespace Real {
             mat->m_UUID = UUID{};
         }
         const std::string uuidStr = std::to_string(mat->m_UUID);
-        nlohmann::json& material = m_AssetDB["materials"][uuidStr];
+        nlohmann::json material;
         material["name"] = mat->m_Name;
 
         material["textures"] = {
@@ -78,15 +143,15 @@ namespace Real {
         };
 
         CacheAssetWithName(mat->m_Name, mat->m_UUID);
-        MarkDirtyAssetDB();
+        PatchAssetDB(EntryPatch("materials", uuidStr, std::move(material)));
     }
 
-    void AssetImporter::SaveModelToAssetDB(const Ref<Model> &model) {
+    void AssetImporter::SaveModelToAssetDB(const Ref<Model> &model, uint64_t sourceHash) {
         if (HasAssetWithPath(model->m_FileInfo.path))
             return;
 
         const std::string uuidStr = std::to_string(model->m_UUID);
-        nlohmann::json& m = m_AssetDB["models"][uuidStr];
+        nlohmann::json m;
 
         // Binary file path
         m["binary"] = std::string(ASSETS_RUNTIME_DIR) + "models/" + model->m_Name + ".model";
@@ -98,8 +163,15 @@ namespace Real {
         m["file_path"]      = model->m_FileInfo.path;
         m["file_extension"] = model->m_FileInfo.ext;
 
+        if (sourceHash != 0) {
+            m["source_hash"]     = sourceHash;
+            m["source_stamp"]    = util::HashFileStamp(model->m_FileInfo.path);
+            m["source_settings"] = ModelLoader::HashSettings();
+            m_CookedModels.try_emplace(sourceHash, model->m_UUID);
+        }
+
         CacheAssetWithPath(model->m_FileInfo.path, model->m_UUID);
-        MarkDirtyAssetDB();
+        PatchAssetDB(EntryPatch("models", uuidStr, std::move(m)));
         Services::GetAssetManager()->SaveModelCPU(model);
     }
 
@@ -109,17 +181,20 @@ namespace Real {
             return;
 
         const std::string uuidStr = std::to_string(header.m_UUID);
-        nlohmann::json& m = m_AssetDB["meshes"][uuidStr];
+        nlohmann::json m;
 
         // Binary file path
         m["binary"] = binaryPath;
         m["name"]   = name; // Engine asset name
 
         CacheAssetWithPath(binaryPath, UUID(header.m_UUID));
-        MarkDirtyAssetDB();
+        PatchAssetDB(EntryPatch("meshes", uuidStr, std::move(m)));
     }
 
     void AssetImporter::ImportFromDatabase() {
+        // Edited model files are imported again by the model loader
+        DropStaleModels();
+
         // Import from DB
         ImportTextures();
         ImportMaterials();
@@ -129,88 +204,275 @@ namespace Real {
         // Iterate folder if there is missing new textures
         LoadTexturesFromFolder();
         // TODO: is a safety check required??
+
+        FlushCompressionQueue();
     }
 
     void AssetImporter::ImportTextures() {
         const auto& am = Services::GetAssetManager();
+        const auto start = std::chrono::steady_clock::now();
+
+        // Collect the DB entries firstly, the decoding order doesn't matter but the saving order does
+        const auto records = m_Registry.GetRecords(serialization::AssetKind::TEXTURE);
+        std::vector<TextureImportEntry> entries;
+        entries.reserve(records.size());
+        for (const auto& record : records) {
+            TextureImportEntry entry;
+            entry.m_UUID  = UUID(record.m_UUID);
+            entry.m_Type  = static_cast<TextureType>(record.m_TextureType);
+            entry.m_State = static_cast<ImageFormatState>(record.m_FormatState);
+
+            entry.m_Info.name = m_Registry.GetString(record.m_Name);
+            entry.m_Info.stem = m_Registry.GetString(record.m_Stem);
+            entry.m_Info.path = m_Registry.GetString(record.m_Path);
+            entry.m_Info.ext  = m_Registry.GetString(record.m_Extension);
+
+            entry.m_SourcePath  = m_Registry.GetString(record.m_SourcePath);
+            entry.m_SourceHash  = record.m_SourceHash;
+            entry.m_SourceStamp = record.m_SourceStamp;
+            entry.m_SourceSettings = record.m_SourceSettings;
+            entries.push_back(std::move(entry));
+        }
 
-        for (const auto& [uuidStr, tex_data] : m_AssetDB["textures"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Material DB");
-                continue;
+        // Pure CPU work (file IO + decoding), safe to run on the workers
+        const auto Decode = [am](TextureImportEntry& entry) {
+            const auto decodeStart = std::chrono::steady_clock::now();
+
+            // Content is hashed only when the stamp or the import settings changed, a touched file (or a fresh checkout) keeps its .dds
+            // New settings change the hash seed, the texture is compressed again then
+            if (entry.m_State == ImageFormatState::COMPRESSED && entry.m_SourceHash != 0) {
+                const uint64_t stamp = util::HashFileStamp(entry.m_SourcePath);
+                const uint64_t settings = HashTextureSettings(entry.m_Type);
+                if (stamp != 0 && (stamp != entry.m_SourceStamp || settings != entry.m_SourceSettings)) {
+                    const uint64_t hash = HashTextureSource(entry.m_SourcePath, entry.m_Type);
+                    if (hash == entry.m_SourceHash) {
+                        entry.m_SourceStamp = stamp;
+                        entry.m_SourceSettings = settings;
+                        entry.m_Touched = true;
+                    }
+                    else if (hash != 0) {
+                        // Compressed again from the source, the UUID stays so the materials don't change
+                        // The compressor reuses a .dds with the same stem, the old one has to go
+                        std::error_code ec;
+                        std::filesystem::remove(ConcatStr(COMPRESSED_TEXTURE_DIR, entry.m_Info.stem, ".dds"), ec);
+                        entry.m_Info  = fs::CreateFileInfoFromPath(entry.m_SourcePath);
+                        entry.m_State = ImageFormatState::COMPRESS_ME;
+                        entry.m_Stale = true;
+                    }
+                }
             }
-            const auto type = util::TextureType_StringToEnum(tex_data["type"]);
-            const auto ifs  = util::ImageFormatState_StringToEnum(tex_data["image_format_state"]);
-
-            FileInfo fi;
-            fi.name = tex_data.value("name", "null");
-            fi.stem = tex_data.value("stem", "null");
-            fi.path = tex_data.value("path", "null");
-            fi.ext  = tex_data.value("extension", "null");
-
-            Ref<OpenGLTexture> texture;
-            if (ifs == ImageFormatState::COMPRESS_ME) {
-                const auto td   = am->LoadTextureFromFile(fi.path, type);
-                texture = CreateRef<OpenGLTexture>(td, true, type, ifs, fi, uuid);
-                tools::CompressTextureAndReadFromFile(texture.get());
-                UpdateTextureInAssetDB(texture.get());
-            }
-            else if (ifs == ImageFormatState::UNCOMPRESSED) {
-                const auto td   = am->LoadTextureFromFile(fi.path, type);
-                texture = CreateRef<OpenGLTexture>(td, true, type, ifs, fi, uuid);
-            }
-            else if (ifs == ImageFormatState::COMPRESSED) {
-                texture = tools::ReadCompressedDataFromDDSFile(fi.path);
-                texture->SetType(type);
-                texture->SetImageFormatState(ifs);
-                texture->SetUUID(uuid);
-            } else {
+
+            const auto& fi = entry.m_Info;
+
+            if (entry.m_State == ImageFormatState::COMPRESS_ME || entry.m_State == ImageFormatState::UNCOMPRESSED) {
+                const auto td   = am->LoadTextureFromFile(fi.path, entry.m_Type);
+                entry.m_Texture = CreateRef<OpenGLTexture>(td, true, entry.m_Type, entry.m_State, fi, entry.m_UUID);
+            }
+            else if (entry.m_State == ImageFormatState::COMPRESSED) {
+                // Pointer overload doesn't touch the asset manager, fallback is handled on the main thread
+                entry.m_Texture = CreateRef<OpenGLTexture>(fi, false, ImageFormatState::COMPRESSED);
+                tools::ReadCompressedDataFromDDSFile(entry.m_Texture.get());
+            }
+
+            entry.m_DecodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart).count();
+        };
+
+        const auto& tm = Services::GetTaskManager();
+        if (m_ParallelImport && tm) {
+            tm->ParallelFor(entries.size(), [&entries, &Decode](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    Decode(entries[i]);
+                }
+            }, 1);
+        } else {
+            for (auto& entry : entries) {
+                Decode(entry);
+            }
+        }
+
+        // Hand the results to the asset manager in DB order
+        double decodeSumMs = 0.0;
+        size_t staleCount = 0;
+        nlohmann::json stamps;
+        for (auto& entry : entries) {
+            decodeSumMs += entry.m_DecodeMs;
+            const auto& fi = entry.m_Info;
+
+            // The folder scan skips the sources which are in the DB already
+            if (!entry.m_SourcePath.empty()) m_CookedSourcePaths.insert(entry.m_SourcePath);
+            if (entry.m_Touched) {
+                auto& tex = stamps["textures"][std::to_string(entry.m_UUID)];
+                tex["source_stamp"]    = entry.m_SourceStamp;
+                tex["source_settings"] = entry.m_SourceSettings;
+            }
+            staleCount += entry.m_Stale;
+
+            Ref<OpenGLTexture> texture = entry.m_Texture;
+            if (entry.m_State == ImageFormatState::COMPRESS_ME) {
+                QueueCompression(texture, true);
+            }
+            else if (entry.m_State == ImageFormatState::COMPRESSED) {
+                if (texture->GetMipMapCount() == 0) {
+                    texture = am->GetOrCreateDefaultTexture(TextureType::ALBEDO);
+                }
+                texture->SetType(entry.m_Type);
+                texture->SetImageFormatState(entry.m_State);
+                texture->SetUUID(entry.m_UUID);
+            }
+            else if (entry.m_State != ImageFormatState::UNCOMPRESSED) {
                 Warn("[LoadTexturesFromAssetDB] Image format state is UNDEFINED: " + fi.path);
                 continue;
             }
 
             am->SaveTextureCPU(texture);
         }
+        if (!stamps.is_null()) PatchAssetDB(stamps);
+
+        const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[AssetImporter] Imported {} textures in {:.1f} ms (decode total {:.1f} ms, speedup x{:.2f}, {})",
+            entries.size(), wallMs, decodeSumMs, wallMs > 0.0 ? decodeSumMs / wallMs : 1.0,
+            m_ParallelImport && tm ? "parallel" : "serial"));
+        if (staleCount > 0)
+            Info(std::format("[AssetImporter] {} textures changed since they were compressed, compressing them again", staleCount));
     }
 
     void AssetImporter::ImportMeshes() {
-        for (const auto& [uuidStr, mesh_data] : m_AssetDB["meshes"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Material DB");
+        const auto& mm = Services::GetMeshManager();
+        const auto start = std::chrono::steady_clock::now();
+
+        // Packing job of the last import still running (ImportFromDatabase called again)
+        FinishPakBuild();
+        auto pak = CreateScope<serialization::AssetPak>();
+        pak->Open(MESH_PAK_PATH);
+
+        // Not in the pak, read (and decompressed) on the workers
+        struct LooseMesh {
+            UUID m_UUID;
+            std::string m_Binary;
+            MeshLoadResult m_Mesh;
+            std::vector<Meshlet> m_Meshlets;
+            uint64_t m_FileSize = 0;
+        };
+        std::vector<LooseMesh> looseMeshes;
+
+        std::vector<serialization::PakMeshSource> sources;
+        size_t pakCount = 0;
+        for (const auto& record : m_Registry.GetRecords(serialization::AssetKind::MESH)) {
+            const UUID meshUUID(record.m_UUID);
+            if (m_DroppedAssets.contains(meshUUID)) continue;
+            sources.push_back({ record.m_UUID, std::string(m_Registry.GetString(record.m_Binary)) });
+
+            // Straight from the mapped pak into the pools, no file opened per mesh
+            if (const auto mesh = pak->FindMesh(record.m_UUID)) {
+                mm->CreateSingleMesh(mesh->m_Vertices, mesh->m_Indices, meshUUID, math::ToAABB(*mesh->m_Header));
+                if (!mesh->m_Meshlets.empty())
+                    mm->SetMeshlets(meshUUID, { mesh->m_Meshlets.begin(), mesh->m_Meshlets.end() });
+                pakCount++;
                 continue;
             }
-            const auto& bPath = mesh_data["binary"];
-            // Save meshes to mesh manager
-            const auto& [header, vertices, indices] = serialization::binary::LoadMesh(bPath);
-            UUID meshUUID{header.m_UUID};
-            Services::GetMeshManager()->CreateSingleMesh(vertices, indices, meshUUID);
+
+            looseMeshes.push_back({ meshUUID, sources.back().m_Binary });
+        }
+
+        // File IO, zstd and the meshlet builds, nothing shared between the meshes
+        const auto Load = [&looseMeshes](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& loose = looseMeshes[i];
+                const auto& bPath = loose.m_Binary;
+                std::error_code ec;
+                loose.m_FileSize = std::filesystem::file_size(bPath, ec);
+                loose.m_Mesh = serialization::binary::LoadMesh(bPath);
+                const auto& [header, vertices, packedVertices, indices] = loose.m_Mesh;
+
+                loose.m_Meshlets = serialization::binary::LoadMeshlets(serialization::binary::MeshletPath(bPath));
+                // Imported before the meshlet builder, build them once here (written for the pak)
+                if (loose.m_Meshlets.empty() && indices.size() / 3 >= MESHLET_MIN_MESH_TRIANGLES) {
+                    if (header.m_VertexFormat == VertexFormat::COMPACT) {
+                        const auto bounds = math::ToAABB(header);
+                        std::vector<Vertex> unpacked(packedVertices.size());
+                        for (size_t v = 0; v < packedVertices.size(); v++)
+                            unpacked[v] = math::UnpackVertex(packedVertices[v], bounds);
+                        loose.m_Meshlets = MeshOptimizer::BuildMeshlets(unpacked, indices);
+                    } else {
+                        loose.m_Meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+                    }
+                    serialization::binary::WriteMeshlets(serialization::binary::MeshletPath(bPath), loose.m_UUID, loose.m_Meshlets);
+                }
+            }
+        };
+        const auto& tm = Services::GetTaskManager();
+        if (m_ParallelImport && tm) {
+            tm->ParallelFor(looseMeshes.size(), Load, 1);
+        } else {
+            Load(0, looseMeshes.size());
         }
+
+        // Save meshes to mesh manager in DB order
+        uint64_t diskBytes = 0, rawBytes = 0;
+        for (auto& loose : looseMeshes) {
+            const auto& [header, vertices, packedVertices, indices] = loose.m_Mesh;
+            const auto bounds = math::ToAABB(header);
+            // Compact binaries go to the pool as they are
+            if (header.m_VertexFormat == VertexFormat::COMPACT)
+                mm->CreateSingleMesh(packedVertices, indices, loose.m_UUID, bounds);
+            else
+                mm->CreateSingleMesh(vertices, indices, loose.m_UUID, bounds);
+            if (!loose.m_Meshlets.empty())
+                mm->SetMeshlets(loose.m_UUID, std::move(loose.m_Meshlets));
+
+            diskBytes += loose.m_FileSize;
+            rawBytes  += sizeof(MeshBinaryHeader) + vertices.size() * sizeof(Vertex) +
+                         packedVertices.size() * sizeof(PackedVertex) + indices.size() * sizeof(uint32_t);
+        }
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[AssetImporter] Imported {} meshes in {:.1f} ms ({} from the pak, {} loose: {:.1f} MB read, {:.1f} MB raw)",
+            sources.size(), ms, pakCount, looseMeshes.size(),
+            static_cast<double>(diskBytes) / (1024.0 * 1024.0), static_cast<double>(rawBytes) / (1024.0 * 1024.0)));
+
+        // New or removed meshes, packed again on a worker for the next start (the pools have their own copy)
+        if (pakCount == sources.size() && pakCount == pak->GetMeshCount()) return;
+
+        m_PakBuild = CreateScope<PakBuild>();
+        m_PakBuild->m_Previous = std::move(pak);
+        m_PakBuild->m_Meshes = std::move(sources);
+        const auto Build = [build = m_PakBuild.get()] {
+            serialization::AssetPak::Build(MESH_PAK_PATH, build->m_Meshes, *build->m_Previous);
+        };
+        if (tm) {
+            m_PakBuild->m_Job = tm->Submit(Build);
+        } else {
+            Build();
+            m_PakBuild.reset();
+        }
+    }
+
+    void AssetImporter::FinishPakBuild() {
+        if (!m_PakBuild) return;
+        if (m_PakBuild->m_Job && !TaskManager::IsDone(m_PakBuild->m_Job))
+            Services::GetTaskManager()->Wait(m_PakBuild->m_Job);
+        m_PakBuild.reset();
     }
 
     void AssetImporter::ImportModels() {
         const auto& am = Services::GetAssetManager();
-        for (const auto& [uuidStr, modeldata] : m_AssetDB["models"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in material DB");
-                continue;
-            }
+        for (const auto& record : m_Registry.GetRecords(serialization::AssetKind::MODEL)) {
+            const UUID uuid(record.m_UUID);
+            if (m_DroppedAssets.contains(uuid)) continue;
 
             FileInfo info;
-            info.name = modeldata["file_name"];
-            info.stem = modeldata["file_stem"];
-            info.path = modeldata["file_path"];
-            info.ext  = modeldata["file_extension"];
+            info.name = m_Registry.GetString(record.m_FileName);
+            info.stem = m_Registry.GetString(record.m_Stem);
+            info.path = m_Registry.GetString(record.m_Path);
+            info.ext  = m_Registry.GetString(record.m_Extension);
 
-            const auto& bPath = modeldata["binary"];
+            const std::string bPath(m_Registry.GetString(record.m_Binary));
             const auto& [header, meshUUIDs, matUUIDs] = serialization::binary::LoadModel(bPath);
 
             const Ref<Model> model = CreateRef<Model>(uuid, info);
             model->m_MeshUUIDs = meshUUIDs;
             model->m_MaterialAssetUUIDs = matUUIDs;
-            model->m_Name = modeldata["name"];
+            model->m_Name = m_Registry.GetString(record.m_Name);
 
             if (header.m_UUID != 0 && header.m_UUID != uuid) {
                 Warn("[AssetImporter] Model UUID mismatch!!! Binary UUID != AssetDbUUID fix it!");
@@ -222,69 +484,23 @@ namespace Real {
 
     void AssetImporter::ImportMaterials() {
         const auto& am = Services::GetAssetManager();
-        for (const auto& [uuidStr, mat_data] : m_AssetDB["materials"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Material DB");
-                continue;
-            }
-            const std::string name = mat_data.value("name", "Material");
+        for (const auto& record : m_Registry.GetRecords(serialization::AssetKind::MATERIAL)) {
+            const std::string name(m_Registry.GetString(record.m_Name));
 
-            const auto& mat = am->LoadMaterialBaseAsset(uuid, name);
+            const auto& mat = am->LoadMaterialBaseAsset(UUID(record.m_UUID), name);
 
-            if (mat_data.contains("textures")) {
-                const nlohmann::json& t = mat_data["textures"];
-
-                mat->m_Albedo   = UUID(t.value("albedo",   0ULL));
-                mat->m_Normal   = UUID(t.value("normal",   0ULL));
-                mat->m_ORM      = UUID(t.value("orm",      0ULL));
-                mat->m_Height   = UUID(t.value("height",   0ULL));
-                mat->m_Emissive = UUID(t.value("emissive", 0ULL));
+            if (record.m_Flags & serialization::ASSET_RECORD_HAS_TEXTURES) {
+                mat->m_Albedo   = UUID(record.m_Textures[0]);
+                mat->m_Normal   = UUID(record.m_Textures[1]);
+                mat->m_ORM      = UUID(record.m_Textures[2]);
+                mat->m_Height   = UUID(record.m_Textures[3]);
+                mat->m_Emissive = UUID(record.m_Textures[4]);
             }
 
             am->SaveMaterialCPU(mat);
         }
     }
 
-    void AssetImporter::BuildCachesFromDB() {
-        for (auto& [uuidStr, tex] : m_AssetDB["textures"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Material DB");
-                continue;
-            }
-            CacheAssetWithPath(tex["path"], uuid);
-        }
-
-        for (const auto& [uuidStr, material] : m_AssetDB["materials"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Material DB");
-                continue;
-            }
-            const std::string name = material.value("name", "Material");
-            CacheAssetWithName(name, uuid);
-        }
-
-        for (auto& [uuidStr, mesh] : m_AssetDB["meshes"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Mesh DB");
-                continue;
-            }
-            CacheAssetWithPath(mesh["binary"], uuid);
-        }
-
-        for (auto& [uuidStr, model] : m_AssetDB["models"].items()) {
-            UUID uuid;
-            if (!util::TryParseUUID(uuidStr, uuid)) {
-                Warn("Invalid UUID in Model DB");
-                continue;
-            }
-            CacheAssetWithPath(model["file_path"], uuid);
-        }
-    }
-
     void AssetImporter::CacheAssetWithName(const std::string &name, const UUID &uuid) {
         if (!HasAssetWithName(name)) {
             m_NameToUUID.emplace(name, uuid);
@@ -301,15 +517,185 @@ namespace Real {
         m_AssetDBDirty = true;
     }
 
+    void AssetImporter::PatchAssetDB(const nlohmann::json &patch) {
+        // In memory copy stays up to date for the snapshots
+        LoadAssetDB();
+        m_AssetDB.merge_patch(patch);
+
+        m_PendingJournal += patch.dump();
+        m_PendingJournal += '\n';
+    }
+
     void AssetImporter::UpdateAssetDB() {
-        if (!m_AssetDBDirty) return;
-        serialization::json::Save(ASSET_DB_PATH, m_AssetDB);
+        FinishCompaction(false);
+        AppendJournal();
+
+        // Direct edits have no journal records, they need a full snapshot
+        if (m_AssetDBDirty && m_AssetDBLoaded)
+            CompactAssetDB(false);
+        else if (m_JournalSize >= ASSET_JOURNAL_COMPACT_SIZE)
+            CompactAssetDB(false);
+    }
+
+    void AssetImporter::AppendJournal() {
+        if (m_PendingJournal.empty()) return;
+
+        std::ofstream file(ASSET_JOURNAL_PATH, std::ios::binary | std::ios::out | std::ios::app);
+        if (!file) {
+            Warn(std::string("[AssetImporter] Journal can't opening: ") + ASSET_JOURNAL_PATH);
+            return;
+        }
+        file.write(m_PendingJournal.data(), static_cast<std::streamsize>(m_PendingJournal.size()));
+        file.flush();
+        if (!file) {
+            Warn("[AssetImporter] Failed to append the journal!");
+            return;
+        }
+
+        m_JournalSize += m_PendingJournal.size();
+        m_PendingJournal.clear();
+    }
+
+    void AssetImporter::ReplayJournal() {
+        if (m_JournalSize == 0) return;
+
+        std::ifstream file(ASSET_JOURNAL_PATH, std::ios::binary | std::ios::in);
+        if (!file) return;
+
+        // Patches only set values, replaying the ones already in the snapshot changes nothing
+        uint64_t validSize = 0;
+        size_t records = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (file.eof()) break; // No newline, the last append was cut
+            if (!line.empty()) {
+                const auto patch = nlohmann::json::parse(line, nullptr, false);
+                if (patch.is_discarded()) break;
+                m_AssetDB.merge_patch(patch);
+                records++;
+            }
+            validSize += line.size() + 1;
+        }
+        file.close();
+
+        if (validSize != m_JournalSize) {
+            Warn(std::format("[AssetImporter] Journal is broken after {} records, the rest is dropped", records));
+            std::error_code ec;
+            std::filesystem::resize_file(ASSET_JOURNAL_PATH, validSize, ec);
+            m_JournalSize = ec ? 0 : validSize;
+        }
+        Info(std::format("[AssetImporter] Replayed {} asset DB journal records", records));
+    }
+
+    void AssetImporter::TrimJournal(uint64_t size) {
+        if (size == 0) return;
+
+        std::error_code ec;
+        if (size >= m_JournalSize) {
+            std::filesystem::resize_file(ASSET_JOURNAL_PATH, 0, ec);
+            m_JournalSize = 0;
+            return;
+        }
+
+        // Records appended while the snapshot was written, they are moved to the front
+        std::string tail(m_JournalSize - size, '\0');
+        {
+            std::ifstream file(ASSET_JOURNAL_PATH, std::ios::binary | std::ios::in);
+            file.seekg(static_cast<std::streamoff>(size));
+            file.read(tail.data(), static_cast<std::streamsize>(tail.size()));
+            if (!file) {
+                Warn("[AssetImporter] Failed to read the journal tail!");
+                return;
+            }
+        }
+        const std::string tmpPath = std::string(ASSET_JOURNAL_PATH) + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            file.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+            if (!file) {
+                Warn("[AssetImporter] Failed to write the journal tail!");
+                return;
+            }
+        }
+        std::filesystem::rename(tmpPath, ASSET_JOURNAL_PATH, ec);
+        if (ec) {
+            Warn("[AssetImporter] Can't replace the journal, " + ec.message());
+            return;
+        }
+        m_JournalSize = tail.size();
+    }
+
+    void AssetImporter::CompactAssetDB(bool wait) {
+        if (m_Compaction) {
+            if (!wait) return;
+            FinishCompaction(true);
+        }
+        LoadAssetDB();
+        AppendJournal();
+
+        // The workers get their own copy, the main thread keeps patching m_AssetDB
+        m_Compaction = CreateScope<Compaction>();
+        m_Compaction->m_Snapshot = m_AssetDB;
+        m_Compaction->m_JournalSize = m_JournalSize;
         m_AssetDBDirty = false;
+
+        const auto Write = [compaction = m_Compaction.get()] {
+            using serialization::AssetRegistry;
+            const auto start = std::chrono::steady_clock::now();
+
+            // Renamed over the old one, a crash never leaves a half written DB behind
+            const std::string tmpPath = std::string(ASSET_DB_PATH) + ".tmp";
+            if (!serialization::json::Save(tmpPath, compaction->m_Snapshot)) return;
+            std::error_code ec;
+            std::filesystem::rename(tmpPath, ASSET_DB_PATH, ec);
+            if (ec) {
+                Warn("[AssetImporter] Can't replace the asset DB, " + ec.message());
+                return;
+            }
+
+            compaction->m_Source   = AssetRegistry::GetSourceStamp(ASSET_DB_PATH);
+            compaction->m_Registry = AssetRegistry::Compile(compaction->m_Snapshot, compaction->m_Source);
+            compaction->m_Saved    = true;
+
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            Info(std::format("[AssetImporter] Asset DB snapshot written in {:.1f} ms", ms));
+        };
+
+        const auto& tm = Services::GetTaskManager();
+        if (wait || !tm) {
+            Write();
+            FinishCompaction(true);
+        } else {
+            m_Compaction->m_Job = tm->Submit(Write);
+        }
+    }
+
+    void AssetImporter::FinishCompaction(bool wait) {
+        if (!m_Compaction) return;
+
+        if (m_Compaction->m_Job && !TaskManager::IsDone(m_Compaction->m_Job)) {
+            if (!wait) return;
+            Services::GetTaskManager()->Wait(m_Compaction->m_Job);
+        }
+        const auto compaction = std::move(m_Compaction);
+
+        // Journal stays as it is, the next compaction tries again
+        if (!compaction->m_Saved) return;
+
+        TrimJournal(compaction->m_JournalSize);
+
+        // Registry of the new snapshot, the caches still have the assets added after it
+        m_Registry.Close();
+        if (!serialization::AssetRegistry::Write(ASSET_REGISTRY_PATH, compaction->m_Registry) ||
+            !m_Registry.Open(ASSET_REGISTRY_PATH, compaction->m_Source))
+        {
+            m_Registry.Open(std::move(compaction->m_Registry), compaction->m_Source);
+        }
     }
 
     void AssetImporter::UpdateTextureInAssetDB(const OpenGLTexture *texture) {
         const std::string uuidStr = std::to_string(texture->GetUUID());
-        auto& tex = m_AssetDB["textures"][uuidStr];
+        nlohmann::json tex;
 
         tex["name"]  = texture->GetName();
         tex["stem"]  = texture->GetStem();
@@ -317,14 +703,18 @@ namespace Real {
         tex["extension"] = texture->GetExtension();
         tex["type"]  = util::TextureType_EnumToString(texture->GetType());
         tex["image_format_state"] = util::ImageFormatState_EnumToString(texture->GetImageFormatState());
+        AddTextureSource(tex, texture->GetUUID());
 
-        MarkDirtyAssetDB();
+        PatchAssetDB(EntryPatch("textures", uuidStr, std::move(tex)));
     }
 
     void AssetImporter::LoadNewAssetsToDataBase() {
         // Update DB firstly if there is new assets
         UpdateAssetDB();
 
+        std::vector<Ref<OpenGLTexture>> newTextures;
+        std::vector<Ref<Material>> newMaterials;
+
         for (const auto& mat : std::views::values(Services::GetAssetManager()->GetBaseMaterials())) {
             if (HasAssetWithName(mat->m_Name)) continue;
 
@@ -332,10 +722,20 @@ namespace Real {
                 if (HasAssetWithPath(tex->GetPath())) continue;
 
                 if (tex->GetImageFormatState() == ImageFormatState::COMPRESS_ME) {
-                    tools::CompressTextureAndReadFromFile(tex.get());
+                    QueueCompression(tex);
                 }
-                SaveTextureToAssetDB(tex.get());
+                newTextures.push_back(tex);
             }
+            newMaterials.push_back(mat);
+        }
+
+        // Paths are changing after the compression, save them later
+        FlushCompressionQueue();
+
+        for (const auto& tex : newTextures) {
+            SaveTextureToAssetDB(tex.get());
+        }
+        for (const auto& mat : newMaterials) {
             SaveMaterialToAssetDB(mat);
         }
 
@@ -348,7 +748,7 @@ namespace Real {
 
         const auto SaveTexture = [this, &m_ormPack, am](const FileInfo& file, ImageFormatState imageFormatState) {
             auto& stem = file.stem;
-            if (HasAssetWithPath(file.path) || am->IsTextureCompressed(stem))
+            if (HasAssetWithPath(file.path) || m_CookedSourcePaths.contains(fs::NormalizePath(file.path)) || am->IsTextureCompressed(stem))
                 return;
 
             const auto dashPos = stem.find('_');
@@ -372,7 +772,7 @@ namespace Real {
             }
 
             if (imageFormatState == ImageFormatState::COMPRESS_ME) {
-                tools::CompressTextureAndReadFromFile(texture.get());
+                QueueCompression(texture);
             }
 
             am->SaveTextureCPU(texture);
@@ -409,20 +809,308 @@ namespace Real {
                 continue;
             }
             am->GetOrCreateMaterialBase(matName)->m_ORM = orm->GetUUID();
-            tools::CompressTextureAndReadFromFile(orm.get());
+            QueueCompression(orm);
             am->SaveTextureCPU(orm);
         }
     }
 
+    void AssetImporter::QueueCompression(const Ref<OpenGLTexture> &texture, bool updateAssetDB) {
+        if (!texture) return;
+
+        const auto it = std::ranges::find_if(m_CompressionQueue, [&](const PendingCompression& pending) {
+            return pending.m_Texture == texture;
+        });
+        if (it != m_CompressionQueue.end()) {
+            it->m_UpdateAssetDB |= updateAssetDB;
+            return;
+        }
+        m_CompressionQueue.push_back({ texture, updateAssetDB });
+    }
+
+    void AssetImporter::FlushCompressionQueue() {
+        if (m_CompressionQueue.empty()) return;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto queue = std::move(m_CompressionQueue);
+        m_CompressionQueue.clear();
+
+        tools::InitCompressonator();
+
+        // The .dds is named after the stem, textures sharing it (foo.png + foo.jpg, a generated ORM + a <mat>_orm source)
+        // would write the same file at the same time. Those go into one group and run one after another
+        std::vector<std::vector<size_t>> groups;
+        std::unordered_map<std::string, size_t> targetToGroup;
+        for (size_t i = 0; i < queue.size(); i++) {
+            const auto* texture = queue[i].m_Texture.get();
+            const auto [it, inserted] = targetToGroup.try_emplace(ConcatStr(COMPRESSED_TEXTURE_DIR, texture->GetStem(), ".dds"), groups.size());
+            if (inserted)
+                groups.emplace_back();
+            else
+                Warn("[AssetImporter] " + texture->GetPath() + " shares its compressed file with another texture: " + it->first);
+            groups[it->second].push_back(i);
+        }
+
+        // No shared state between the groups (the cooked maps are only read here)
+        const auto Compress = [this](PendingCompression& pending) {
+            auto* texture = pending.m_Texture.get();
+            if (!texture->IsCPUGenerated()) {
+                pending.m_SourcePath  = fs::NormalizePath(texture->GetPath());
+                pending.m_SourceHash  = HashTextureSource(pending.m_SourcePath, texture->GetType());
+                pending.m_SourceStamp = util::HashFileStamp(pending.m_SourcePath);
+                pending.m_SourceSettings = HashTextureSettings(texture->GetType());
+
+                // Same content was compressed before under another name, the compressor picks up the copy
+                const std::string target = ConcatStr(COMPRESSED_TEXTURE_DIR, texture->GetStem(), ".dds");
+                if (pending.m_SourceHash != 0 && !fs::File::Exists(target)) {
+                    if (const auto cooked = FindCookedTexture(pending.m_SourceHash); !cooked.empty()) {
+                        std::error_code ec;
+                        pending.m_Reused = std::filesystem::copy_file(cooked, target, ec) && !ec;
+                    }
+                }
+            }
+            tools::CompressTextureAndReadFromFile(texture);
+        };
+
+        const auto& tm = Services::GetTaskManager();
+        if (tm) {
+            tm->ParallelFor(groups.size(), [&queue, &groups, &Compress](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    for (const size_t index : groups[i]) {
+                        Compress(queue[index]);
+                    }
+                }
+            }, 1);
+        } else {
+            for (auto& pending : queue) {
+                Compress(pending);
+            }
+        }
+
+        // Patch the DB once for the whole batch
+        size_t reusedCount = 0;
+        for (const auto& pending : queue) {
+            const auto* texture = pending.m_Texture.get();
+            if (pending.m_SourceHash != 0 && texture->GetImageFormatState() == ImageFormatState::COMPRESSED) {
+                m_TextureSources[texture->GetUUID()] = { pending.m_SourcePath, pending.m_SourceHash, pending.m_SourceStamp, pending.m_SourceSettings };
+                m_CookedTextures.try_emplace(pending.m_SourceHash, texture->GetPath());
+                m_CookedSourcePaths.insert(pending.m_SourcePath);
+            }
+            reusedCount += pending.m_Reused;
+
+            if (pending.m_UpdateAssetDB)
+                UpdateTextureInAssetDB(texture);
+        }
+        UpdateAssetDB();
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[AssetImporter] Compressed {} textures in {:.1f} ms ({} reused from the cache)", queue.size(), ms, reusedCount));
+    }
+
     void AssetImporter::Update() {
         UpdateAssetDB();
     }
 
     bool AssetImporter::HasAssetWithName(const std::string &sourceName) const {
-        return m_NameToUUID.contains(sourceName);
+        return m_NameToUUID.contains(sourceName) || m_Registry.FindByName(sourceName);
     }
 
     bool AssetImporter::HasAssetWithPath(const std::string &sourcePath) const {
-        return m_PathToUUID.contains(fs::NormalizePath(sourcePath));
+        const std::string path = fs::NormalizePath(sourcePath);
+        if (m_PathToUUID.contains(path)) return true;
+        return !m_DroppedPaths.contains(path) && m_Registry.FindByPath(path);
+    }
+
+    uint64_t AssetImporter::HashTextureSettings(TextureType type) {
+        // Same file with another type is cooked differently (channel count), it goes in with the version
+        const uint64_t settings[] = { TEXTURE_IMPORT_VERSION, static_cast<uint64_t>(type) };
+        const uint64_t key = util::XXH64(settings, sizeof(settings));
+        return key != 0 ? key : 1; // 0 means unknown
+    }
+
+    uint64_t AssetImporter::HashTextureSource(const std::string &path, TextureType type) {
+        uint64_t hash = 0;
+        if (!util::TryHashFile(path, hash, HashTextureSettings(type)))
+            return 0;
+        return hash != 0 ? hash : 1; // 0 means unknown
+    }
+
+    void AssetImporter::AddTextureSource(nlohmann::json &tex, const UUID &uuid) const {
+        const auto it = m_TextureSources.find(uuid);
+        if (it == m_TextureSources.end()) return;
+
+        tex["source_path"]  = it->second.m_Path;
+        tex["source_hash"]  = it->second.m_Hash;
+        tex["source_stamp"] = it->second.m_Stamp;
+        tex["source_settings"] = it->second.m_Settings;
+    }
+
+    std::string AssetImporter::FindCookedTexture(uint64_t sourceHash) const {
+        if (const auto it = m_CookedTextures.find(sourceHash); it != m_CookedTextures.end())
+            return it->second;
+
+        if (const auto* record = m_Registry.FindBySourceHash(sourceHash, serialization::AssetKind::TEXTURE))
+            return std::string(m_Registry.GetString(record->m_Path));
+        return {};
+    }
+
+    UUID AssetImporter::FindCookedModel(uint64_t sourceHash) const {
+        if (const auto it = m_CookedModels.find(sourceHash); it != m_CookedModels.end())
+            return it->second;
+
+        const auto* record = m_Registry.FindBySourceHash(sourceHash, serialization::AssetKind::MODEL);
+        if (!record || m_DroppedAssets.contains(UUID(record->m_UUID)))
+            return UUID(0);
+        return UUID(record->m_UUID);
+    }
+
+    void AssetImporter::DropStaleModels() {
+        const auto records = m_Registry.GetRecords(serialization::AssetKind::MODEL);
+
+        // Model files are only hashed when their stamp or the import settings changed
+        // New settings change the hash seed, the models are imported again then
+        const uint64_t settings = ModelLoader::HashSettings();
+        const auto Unchanged = [settings](const serialization::AssetRecord& record, uint64_t stamp) {
+            return stamp == record.m_SourceStamp && settings == record.m_SourceSettings;
+        };
+
+        struct SourceCheck {
+            uint64_t m_Stamp = 0;
+            uint64_t m_Hash = 0;
+        };
+        std::vector<SourceCheck> checks(records.size());
+        const auto Check = [this, &records, &checks, &Unchanged](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const std::string path(m_Registry.GetString(records[i].m_Path));
+                checks[i].m_Stamp = util::HashFileStamp(path);
+                if (checks[i].m_Stamp != 0 && !Unchanged(records[i], checks[i].m_Stamp))
+                    checks[i].m_Hash = ModelLoader::HashSource(path);
+            }
+        };
+        if (const auto& tm = Services::GetTaskManager(); tm && m_ParallelImport) {
+            tm->ParallelFor(records.size(), Check, 1);
+        } else {
+            Check(0, records.size());
+        }
+
+        nlohmann::json patch;
+        std::unordered_set<std::string_view> droppedNames;
+        for (size_t i = 0; i < records.size(); i++) {
+            const auto& record = records[i];
+            const auto& check = checks[i];
+            // Missing file (the binary is enough) or nothing changed
+            if (check.m_Stamp == 0 || Unchanged(record, check.m_Stamp) || check.m_Hash == 0) continue;
+
+            if (check.m_Hash != record.m_SourceHash && record.m_SourceHash != 0) {
+                droppedNames.insert(m_Registry.GetString(record.m_Name));
+                continue;
+            }
+            // Same content (touched, fresh checkout) or imported before the hashes/settings key, only the stamp is new
+            auto& m = patch["models"][std::to_string(record.m_UUID)];
+            m["source_hash"]     = check.m_Hash;
+            m["source_stamp"]    = check.m_Stamp;
+            m["source_settings"] = settings;
+        }
+
+        // Copied folders share the cooked meshes (ReuseCookedModels), the ones still used by another model stay
+        std::unordered_set<UUID> usedMeshes;
+        if (!droppedNames.empty()) {
+            for (const auto& record : records) {
+                if (droppedNames.contains(m_Registry.GetString(record.m_Name))) continue;
+                const auto& [header, meshUUIDs, matUUIDs] = serialization::binary::LoadModel(std::string(m_Registry.GetString(record.m_Binary)));
+                usedMeshes.insert(meshUUIDs.begin(), meshUUIDs.end());
+            }
+        }
+
+        // Edited, the models go away with their meshes and the model loader imports the folder again
+        // The whole folder (same name), the loader skips folders with a known model name
+        size_t droppedCount = 0;
+        for (const auto& record : records) {
+            if (!droppedNames.contains(m_Registry.GetString(record.m_Name))) continue;
+
+            const std::string binary(m_Registry.GetString(record.m_Binary));
+            const auto& [header, meshUUIDs, matUUIDs] = serialization::binary::LoadModel(binary);
+            std::error_code ec;
+            for (const auto& meshUUID : meshUUIDs) {
+                if (usedMeshes.contains(meshUUID)) continue;
+                m_DroppedAssets.insert(meshUUID);
+                patch["meshes"][std::to_string(meshUUID)] = nullptr;
+                if (const auto* mesh = m_Registry.FindByUUID(meshUUID)) {
+                    const std::string meshBinary(m_Registry.GetString(mesh->m_Binary));
+                    std::filesystem::remove(meshBinary, ec);
+                    std::filesystem::remove(serialization::binary::MeshletPath(meshBinary), ec);
+                }
+            }
+            m_DroppedAssets.insert(UUID(record.m_UUID));
+            m_DroppedPaths.insert(std::string(m_Registry.GetString(record.m_Key)));
+            patch["models"][std::to_string(record.m_UUID)] = nullptr;
+            std::filesystem::remove(binary, ec);
+            droppedCount++;
+        }
+
+        if (!patch.is_null()) PatchAssetDB(patch);
+        if (droppedCount > 0)
+            Info(std::format("[AssetImporter] {} models changed since they were imported, importing them again", droppedCount));
+    }
+
+    bool AssetImporter::ReuseCookedModels(const std::string &name, const std::vector<std::string> &sourcePaths,
+        const std::vector<uint64_t> &sourceHashes)
+    {
+        const auto& am = Services::GetAssetManager();
+
+        // All or nothing, a half reused folder would be imported again anyway
+        std::vector<Ref<Model>> cooked;
+        for (const uint64_t hash : sourceHashes) {
+            const UUID uuid = hash != 0 ? FindCookedModel(hash) : UUID(0);
+            const auto model = uuid.IsNull() ? nullptr : am->GetModel(uuid);
+            if (!model) return false;
+            cooked.push_back(model);
+        }
+
+        for (size_t i = 0; i < cooked.size(); i++) {
+            const auto& model = cooked[i];
+            const auto info = fs::CreateFileInfoFromPath(sourcePaths[i]);
+            const std::string binary = std::string(ASSETS_RUNTIME_DIR) + "models/" + name + ".model";
+
+            if (!fs::File::Exists(model->m_FileInfo.path)) {
+                // Renamed or moved folder, the model follows its files
+                const std::string oldBinary = std::string(ASSETS_RUNTIME_DIR) + "models/" + model->m_Name + ".model";
+                am->RenameModel(name, model->m_UUID);
+                model->m_FileInfo = info;
+
+                ModelBinaryHeader header{};
+                header.m_UUID = model->m_UUID;
+                serialization::binary::WriteModel(binary, header, model->m_MeshUUIDs, model->m_MaterialAssetUUIDs);
+                if (oldBinary != binary) {
+                    std::error_code ec;
+                    std::filesystem::remove(oldBinary, ec);
+                }
+
+                nlohmann::json m;
+                m["binary"]         = binary;
+                m["name"]           = name;
+                m["file_name"]      = info.name;
+                m["file_stem"]      = info.stem;
+                m["file_path"]      = info.path;
+                m["file_extension"] = info.ext;
+                m["source_stamp"]   = util::HashFileStamp(info.path);
+                m["source_settings"] = ModelLoader::HashSettings();
+                CacheAssetWithPath(info.path, model->m_UUID);
+                PatchAssetDB(EntryPatch("models", std::to_string(model->m_UUID), std::move(m)));
+            } else {
+                // Copied folder, a new model sharing the cooked meshes and materials
+                const auto copy = CreateRef<Model>(UUID{}, info);
+                copy->m_Name = name;
+                copy->m_MeshUUIDs = model->m_MeshUUIDs;
+                copy->m_MaterialAssetUUIDs = model->m_MaterialAssetUUIDs;
+
+                ModelBinaryHeader header{};
+                header.m_UUID = copy->m_UUID;
+                serialization::binary::WriteModel(binary, header, copy->m_MeshUUIDs, copy->m_MaterialAssetUUIDs);
+                SaveModelToAssetDB(copy, sourceHashes[i]);
+            }
+        }
+
+        Info(std::format("[AssetImporter] Model folder {} reused {} cooked models, nothing to import", name, cooked.size()));
+        return true;
     }
 }
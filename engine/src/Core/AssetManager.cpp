@@ -48,6 +48,10 @@ namespace Real {
         // m_Shaders[name] = Shader{vert, frag, name};
     }
 
+    void AssetManager::LoadComputeShader(const std::string &computePath, const std::string &name) {
+        m_Shaders[name] = Shader{PreprocessorForShaders(computePath), name};
+    }
+
     std::string AssetManager::PreprocessorForShaders(const std::string &filePath) {
         using namespace std;
 
@@ -243,7 +247,7 @@ namespace Real {
         const auto instance = CreateRef<MaterialInstance>(base);
         instance->m_UUID = UUID{};
 
-        m_MaterialInstances.emplace(instance->m_UUID, instance);
+        m_MaterialInstanceHandles[instance->m_UUID] = m_MaterialInstances.Insert(instance);
         return instance->m_UUID;
     }
 
@@ -266,13 +270,23 @@ namespace Real {
     }
 
     Ref<MaterialInstance> AssetManager::GetMaterialInstance(const UUID &instanceUUID) {
-        const auto it = m_MaterialInstances.find(instanceUUID);
-        if (it == m_MaterialInstances.end()) {
+        const auto handle = GetMaterialInstanceHandle(instanceUUID);
+        if (!handle.IsValid()) {
             Warn("There is no material instance with this UUID: " + std::to_string(instanceUUID));
             return nullptr;
             // TODO: i need to add material asset fallback
         }
-        return it->second;
+        return GetMaterialInstance(handle);
+    }
+
+    MaterialHandle AssetManager::GetMaterialInstanceHandle(const UUID &instanceUUID) const {
+        const auto it = m_MaterialInstanceHandles.find(instanceUUID);
+        return it != m_MaterialInstanceHandles.end() ? it->second : MaterialHandle{};
+    }
+
+    Ref<MaterialInstance> AssetManager::GetMaterialInstance(const MaterialHandle &handle) const {
+        const auto* instance = m_MaterialInstances.Get(handle);
+        return instance ? *instance : nullptr;
     }
 
     Ref<Material> AssetManager::GetOrCreateMaterialBase(const std::string& name) {
@@ -368,6 +382,24 @@ namespace Real {
         return false;
     }
 
+    Ref<Model> AssetManager::GetModel(const UUID &uuid) {
+        const auto it = m_Models.find(uuid);
+        return it != m_Models.end() ? it->second : nullptr;
+    }
+
+    void AssetManager::RenameModel(const std::string &newName, const UUID &uuid) {
+        const auto it = m_Models.find(uuid);
+        if (it == m_Models.end()) {
+            Warn("[RenameModel] Model not found: " + std::to_string(uuid));
+            return;
+        }
+        const auto& model = it->second;
+        if (const auto old = m_ModelNameToUUID.find(model->m_Name); old != m_ModelNameToUUID.end() && old->second == uuid)
+            m_ModelNameToUUID.erase(old);
+        model->m_Name = newName;
+        m_ModelNameToUUID[newName] = uuid;
+    }
+
     void AssetManager::SaveModelCPU(const Ref<Model> &model) {
         if (!m_Models.contains(model->m_UUID)) {
             m_Models.emplace(model->m_UUID, model);
@@ -390,11 +422,10 @@ namespace Real {
     void AssetManager::RenameMaterial(const std::string &newName, const UUID &uuid) {
         const std::string uuidStr = std::to_string(uuid);
 
-        const auto& ai = Services::GetAssetImporter();
-        auto& db = ai->GetAssetDB();
-
-        // Update JSON
-        db["materials"][uuidStr]["name"] = newName;
+        // Update JSON, only the name goes into the journal
+        nlohmann::json patch;
+        patch["materials"][uuidStr]["name"] = newName;
+        Services::GetAssetImporter()->PatchAssetDB(patch);
 
         // TODO: Should i change the texture names as well???
 
@@ -403,8 +434,6 @@ namespace Real {
         m_MaterialNameToUUID.erase(mat->m_Name); // old name
         mat->m_Name = newName;
         m_MaterialNameToUUID[newName] = uuid;
-
-        ai->MarkDirtyAssetDB();
     }
 
     void AssetManager::LoadDefaultTextures() {
@@ -27,6 +27,8 @@ namespace Real {
         m_Window.reset();
         m_EditorState.reset();
         m_AssetImporter.reset();
+        // Workers are joined here, nothing should submit jobs after this point
+        m_TaskManager.reset();
         ShutDown();
     }
 
@@ -34,6 +36,7 @@ namespace Real {
         // The order is matter!
         InitWindow();
         InitCallbacks(m_Window->GetGLFWWindow());
+        InitTaskManager();
         InitSystems();
         InitAssetImporter();
         InitAssetManager();
@@ -83,7 +86,32 @@ namespace Real {
     void Engine::RenderPhase() const {
         // Draw OpenGL stuff
         m_EditorPanel->Render(m_Scene.get(), m_Renderer.get());
-        // TODO: Requires double buffering to switch between each other (Thread-safe rendering and to keep sync CPU-GPU)
+    }
+
+    void Engine::PipelinedPhase() const {
+        // Main thread only stuff (input, GL uploads of the new assets)
+        m_EditorTimer->Update();
+        Input::Update(m_CameraInput.get());
+        m_AssetImporter->Update();
+        m_AssetManager->Update();
+
+        const auto& context = m_Renderer->GetRenderContext();
+
+        // Frame N+1: simulation and extraction into the back snapshot on a worker
+        const auto frameJob = m_TaskManager->Submit([this, context, delta = m_EditorTimer->GetDelta()] {
+            m_Systems->UpdateAll(m_Scene.get(), delta);
+            context->ExtractFrame();
+        });
+
+        // Frame N: submit the front snapshot meanwhile
+        context->UploadToGPU();
+        m_Renderer->Render(m_EditorState->camera);
+
+        m_TaskManager->Wait(frameJob);
+
+        // Editor UI reads and modifies the registry, so it waits for the simulation
+        m_EditorPanel->RenderUI(m_Scene.get(), m_Renderer.get());
+        context->SwapFrames();
     }
 
     void Engine::EndPhase(GLFWwindow* window) {
@@ -102,6 +130,7 @@ namespace Real {
         Services::SetEditorTimer(m_EditorTimer.get());
         Services::SetEditorState(m_EditorState.get());
         Services::SetAssetImporter(m_AssetImporter.get());
+        Services::SetTaskManager(m_TaskManager.get());
         // TODO: Need Shader manager?
 
         Info("Services initialized successfully!");
@@ -114,6 +143,11 @@ namespace Real {
         Info("Systems initialized successfully!");
     }
 
+    void Engine::InitTaskManager() {
+        m_TaskManager = CreateScope<TaskManager>();
+        Info("Task Manager initialized successfully!");
+    }
+
     void Engine::InitAssetImporter() {
         m_AssetImporter = CreateScope<AssetImporter>();
         Info("Asset Importer initialized successfully!");
@@ -261,6 +295,9 @@ namespace Real {
             Services::GetAssetManager()->CreateMaterialInstance("Marble009")
         );
 
+        // Walls hide most of the models from the inside
+        m_Scene->GetRenderSettings().m_OcclusionCulling = true;
+
         Info("Game resources loaded successfully!");
     }
 
@@ -271,8 +308,13 @@ namespace Real {
         SetOpenGLStateFunctions();
         while (!glfwWindowShouldClose(window) && !Input::IsKeyPressed(REAL_KEY_ESCAPE)) {
             StartPhase();
-            UpdatePhase();
-            RenderPhase(); // TODO: Thread-safe rendering
+            if (m_EditorState->PipelinedRendering) {
+                // CPU frame time = max(simulation, render) instead of the sum, one frame of latency
+                PipelinedPhase();
+            } else {
+                UpdatePhase();
+                RenderPhase();
+            }
             EndPhase(window);
         }
     }
@@ -9,6 +9,7 @@ namespace {
     Real::Timer *s_EditorTimer;
     Real::EditorState* s_EditorState;
     Real::AssetImporter* s_AssetImporter;
+    Real::TaskManager* s_TaskManager;
 }
 
 namespace Real::Services {
@@ -31,6 +32,10 @@ namespace Real::Services {
     void SetAssetImporter(AssetImporter *importer) {
         s_AssetImporter = importer;
     }
+
+    void SetTaskManager(TaskManager *manager) {
+        s_TaskManager = manager;
+    }
 }
 
 namespace Real::Services {
@@ -53,4 +58,8 @@ namespace Real::Services {
     AssetImporter* GetAssetImporter() {
         return s_AssetImporter;
     }
+
+    TaskManager* GetTaskManager() {
+        return s_TaskManager;
+    }
 }
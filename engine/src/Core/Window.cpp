@@ -26,6 +26,9 @@ namespace Real::Graphics {
         glfwWindowHint(GLFW_OPENGL_PROFILE,        GLFW_OPENGL_CORE_PROFILE);
         glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT,  GL_TRUE);
+        // Depth pyramid blits this depth into a GL_DEPTH24_STENCIL8 texture, the formats have to match
+        glfwWindowHint(GLFW_DEPTH_BITS,            24);
+        glfwWindowHint(GLFW_STENCIL_BITS,          8);
 
         m_Window = glfwCreateWindow(m_Width, m_Height, m_Title.c_str(), m_GlfwMonitor, m_GlfwShare);
         if (!m_Window) {
@@ -8,6 +8,17 @@
 #include "Core/Logger.h"
 #include "Core/Utils.h"
 
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 namespace Real::fs {
 
     std::string File::ReadFromFile(const std::string &path) {
@@ -48,6 +59,67 @@ namespace Real::fs {
         return false;
     }
 
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string &path) {
+        Close();
+#ifdef _WIN32
+        m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_File == INVALID_HANDLE_VALUE) {
+            m_File = nullptr;
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0) {
+            Close();
+            return false;
+        }
+        m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_Mapping) {
+            Close();
+            return false;
+        }
+        m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+        m_Size = static_cast<size_t>(size.QuadPart);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // The mapping keeps its own reference
+        if (data == MAP_FAILED) return false;
+
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = static_cast<size_t>(st.st_size);
+#endif
+        if (!m_Data) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close() {
+#ifdef _WIN32
+        if (m_Data)    UnmapViewOfFile(m_Data);
+        if (m_Mapping) CloseHandle(m_Mapping);
+        if (m_File)    CloseHandle(m_File);
+        m_Mapping = nullptr;
+        m_File = nullptr;
+#else
+        if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
     std::vector<FileInfo> IterateDirectory(const std::string &folderPath) {
         std::vector<FileInfo> files;
         namespace fs = std::filesystem;
@@ -20,6 +20,7 @@
 #include "Input/Input.h"
 #include "Math/Math.h"
 #include "Scene/Components.h"
+#include "Scene/Scene.h"
 
 namespace Real::UI {
 
@@ -51,6 +52,12 @@ namespace Real::UI {
     }
 
     void EditorPanel::Render(Scene* scene, opengl::Renderer* renderer) {
+        // Main Scene window
+        renderer->Render(Services::GetEditorState()->camera);
+        RenderUI(scene, renderer);
+    }
+
+    void EditorPanel::RenderUI(Scene* scene, opengl::Renderer* renderer) {
         // Scene window props
         // Hierarchy,Inspector width = SCREEN_WIDTH / 5 + 31.0
         // MenuBarPanel height = 25.0
@@ -61,8 +68,6 @@ namespace Real::UI {
                                      ImGuiWindowFlags_NoCollapse   | ImGuiWindowFlags_NoTitleBar;
         // Draw main scene window into Editor Window
         ImGui::Begin("Scene", nullptr, windowFlags);
-        // Main Scene window
-        renderer->Render(Services::GetEditorState()->camera);
         // Draw UI
         Render(scene);
 
@@ -101,14 +106,28 @@ namespace Real::UI {
         ImGui::PopStyleVar();
     }
 
-    void EditorPanel::DrawPerformanceProfile() {
+    void EditorPanel::DrawPerformanceProfile(const Scene* scene) {
         if (Input::IsKeyPressed(REAL_KEY_F11)) openPerfProfile = !openPerfProfile;
         if (openPerfProfile) return;
         const auto fps = "FPS: " + std::to_string(Services::GetEditorTimer()->GetFPS());
         ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), fps.c_str());
+        const auto pipelined = std::string("Pipelined (F4): ") + (Services::GetEditorState()->PipelinedRendering ? "ON" : "OFF");
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), pipelined.c_str());
+        const auto& state = Services::GetEditorState();
+        const auto culling = std::string("Culling (F5): ") + (state->FrustumCulling ? "ON" : "OFF");
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), culling.c_str());
+        const auto gpuCulling = std::string("GPU culling (F6): ") + (state->GPUCulling ? "ON" : "OFF");
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), gpuCulling.c_str());
+        const auto occlusion = std::string("Occlusion culling (F7): ") + (scene->GetRenderSettings().m_OcclusionCulling ? "ON" : "OFF");
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), occlusion.c_str());
+        const auto instances = "Visible: " + std::to_string(state->VisibleInstances) + " Culled: " + std::to_string(state->CulledInstances)
+            + " Occluded: " + std::to_string(state->OccludedInstances);
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), instances.c_str());
+        const auto meshlets = "Meshlets visible: " + std::to_string(state->VisibleMeshlets) + " Culled: " + std::to_string(state->CulledMeshlets);
+        ImGui::TextColored(ImVec4(1.0, 1.0, 1.0, 1.0), meshlets.c_str());
     }
 
-    void EditorPanel::UpdateInputUI() {
+    void EditorPanel::UpdateInputUI(Scene* scene) {
         if (!ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow) && ImGui::IsMouseClicked(0) && !ImGui::IsAnyItemHovered()) {
             Services::GetEditorState()->selectedEntity = nullptr;
         }
@@ -116,6 +135,23 @@ namespace Real::UI {
         if (Input::IsKeyPressed(REAL_KEY_F3)) {
             Services::GetEditorState()->FpsMode = !Services::GetEditorState()->FpsMode;
         }
+
+        if (Input::IsKeyPressed(REAL_KEY_F4)) {
+            Services::GetEditorState()->PipelinedRendering = !Services::GetEditorState()->PipelinedRendering;
+        }
+
+        if (Input::IsKeyPressed(REAL_KEY_F5)) {
+            Services::GetEditorState()->FrustumCulling = !Services::GetEditorState()->FrustumCulling;
+        }
+
+        if (Input::IsKeyPressed(REAL_KEY_F6)) {
+            Services::GetEditorState()->GPUCulling = !Services::GetEditorState()->GPUCulling;
+        }
+
+        if (Input::IsKeyPressed(REAL_KEY_F7)) {
+            auto& settings = scene->GetRenderSettings();
+            settings.m_OcclusionCulling = !settings.m_OcclusionCulling;
+        }
     }
 
     void EditorPanel::InitFontStyle() {
@@ -207,9 +243,9 @@ namespace Real::UI {
     }
 
     void EditorPanel::Render(Scene* scene) {
-        UpdateInputUI();
+        UpdateInputUI(scene);
         RenderMenuBar();
-        DrawPerformanceProfile();
+        DrawPerformanceProfile(scene);
         DrawGizmos();
         // DebugGizmos();
     }
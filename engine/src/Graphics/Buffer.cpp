@@ -2,6 +2,8 @@
 // Created by pointerlost on 10/12/25.
 //
 #include "Graphics/Buffer.h"
+#include <algorithm>
+#include <format>
 
 namespace Real::opengl {
 
@@ -9,19 +11,122 @@ namespace Real::opengl {
         CleanResources();
     }
 
+    void Buffer::CreateRing(GLsizeiptr regionSize, uint32_t regionCount) {
+        CleanResources();
+
+        // Bind offsets of the regions have to be aligned
+        GLint alignment = 256;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_RegionSize  = (regionSize + alignment - 1) / alignment * alignment;
+        m_RegionCount = regionCount;
+        m_Region      = 0;
+        m_Size        = m_RegionSize * m_RegionCount;
+        m_Fences.assign(m_RegionCount, nullptr);
+
+        Create(std::vector<uint8_t>{}, BufferType::SSBO);
+    }
+
+    void Buffer::BeginFrame() {
+        if (!IsRing()) return;
+        m_Region = (m_Region + 1) % m_RegionCount;
+
+        // Wait until the GPU is done with the frame which used this region
+        auto& fence = m_Fences[m_Region];
+        if (!fence) return;
+
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        if (result == GL_WAIT_FAILED) {
+            Warn("[Buffer::BeginFrame] glClientWaitSync failed!");
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    void Buffer::EndFrame() {
+        if (!IsRing()) return;
+        auto& fence = m_Fences[m_Region];
+        if (fence) glDeleteSync(fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void Buffer::Grow(GLsizeiptr requiredRegionSize) {
+        GLsizeiptr regionSize = std::max<GLsizeiptr>(m_RegionSize, 1);
+        while (regionSize < requiredRegionSize) {
+            regionSize *= 2;
+        }
+        // Same layout, the content just gets more room
+        Relayout(regionSize, { { 0, 0, m_RegionSize } });
+    }
+
+    void Buffer::Relayout(GLsizeiptr newRegionSize, const std::vector<BufferCopy> &copies) {
+        const GLuint oldBuffer = m_Buffer;
+        const GLsizeiptr oldRegionSize = m_RegionSize;
+
+        if (oldBuffer != 0 && m_Ptr) {
+            glUnmapNamedBuffer(oldBuffer);
+        }
+        m_Ptr = nullptr;
+        m_Buffer = 0;
+
+        m_RegionSize = newRegionSize;
+        m_Size = m_RegionSize * m_RegionCount;
+        Create(std::vector<uint8_t>{}, BufferType::SSBO);
+
+        // GPU to GPU copy, every region keeps its content (persistent slots live in there)
+        if (oldBuffer != 0) {
+            for (uint32_t i = 0; i < m_RegionCount; i++) {
+                for (const auto& copy : copies) {
+                    if (copy.m_Size <= 0) continue;
+                    glCopyNamedBufferSubData(oldBuffer, m_Buffer,
+                        i * oldRegionSize + copy.m_SrcOffset, i * m_RegionSize + copy.m_DstOffset, copy.m_Size
+                    );
+                }
+            }
+            // Deletion is deferred by the driver until the pending frames are done with it
+            glDeleteBuffers(1, &oldBuffer);
+        }
+        Info(std::format("[Buffer] Region size is {} bytes now ({} regions)", m_RegionSize, m_RegionCount));
+    }
+
     void Buffer::Bind(GLenum target, BufferType type, GLuint bindingPoint) const {
         if (type == BufferType::SSBO) {
-            glBindBufferBase(target, bindingPoint, m_Buffer);
+            glBindBufferRange(target, bindingPoint, m_Buffer, GetRegionOffset(), m_RegionSize);
         } else if (type == BufferType::UBO) {
             glBindBufferBase(target, bindingPoint, m_Buffer);
         }
     }
 
+    void Buffer::Write(const void *data, GLintptr offset, GLsizeiptr size) const {
+        if (!m_Ptr) {
+            Warn("[Buffer::Write] Buffer is not persistent mapped!");
+            return;
+        }
+        if (offset + size > m_RegionSize) {
+            Warn("[Buffer::Write] Out of range write!");
+            return;
+        }
+        memcpy(static_cast<uint8_t*>(m_Ptr) + GetRegionOffset() + offset, data, size);
+    }
+
+    void Buffer::FlushRange(GLintptr offset, GLsizeiptr size) const {
+        if (!m_Ptr || size <= 0) return;
+        glFlushMappedNamedBufferRange(m_Buffer, GetRegionOffset() + offset, size);
+    }
+
     void Buffer::CleanResources() {
+        for (auto& fence : m_Fences) {
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
         if (m_Ptr) {
             glUnmapNamedBuffer(m_Buffer);
             m_Ptr = nullptr;
         }
         glDeleteBuffers(1, &m_Buffer);
+        m_Buffer = 0;
     }
 }
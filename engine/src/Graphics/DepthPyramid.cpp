@@ -0,0 +1,83 @@
+//
+// Created by pointerlost on 1/15/26.
+//
+#include "Graphics/DepthPyramid.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include "Core/AssetManager.h"
+#include "Core/Logger.h"
+#include "Core/Services.h"
+
+namespace Real::opengl {
+
+    static constexpr GLuint HIZ_GROUP_SIZE = 8; // local_size_x/y of hiz.comp
+
+    DepthPyramid::~DepthPyramid() {
+        Release();
+    }
+
+    void DepthPyramid::Release() {
+        if (m_DepthFBO != 0) glDeleteFramebuffers(1, &m_DepthFBO);
+        const std::array<GLuint, 2> textures = { m_DepthCopy, m_Pyramid };
+        glDeleteTextures(2, textures.data());
+        m_DepthFBO = m_DepthCopy = m_Pyramid = 0;
+    }
+
+    void DepthPyramid::Resize(int width, int height) {
+        Release();
+        m_Width  = width;
+        m_Height = height;
+        m_Levels = std::bit_width(static_cast<uint32_t>(std::max(width, height)));
+
+        // Window depth is 24/8 (Window::Init asks for it)
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_DepthCopy);
+        glTextureStorage2D(m_DepthCopy, 1, GL_DEPTH24_STENCIL8, width, height);
+        glTextureParameteri(m_DepthCopy, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_DepthCopy, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glCreateFramebuffers(1, &m_DepthFBO);
+        glNamedFramebufferTexture(m_DepthFBO, GL_DEPTH_STENCIL_ATTACHMENT, m_DepthCopy, 0);
+        if (glCheckNamedFramebufferStatus(m_DepthFBO, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            Warn("[DepthPyramid] Depth copy framebuffer is not complete!");
+        }
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_Pyramid);
+        glTextureStorage2D(m_Pyramid, m_Levels, GL_R32F, width, height);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        Info(std::format("[DepthPyramid] {}x{}, {} levels", width, height, m_Levels));
+    }
+
+    void DepthPyramid::Build() {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        const int width = viewport[2], height = viewport[3];
+        if (width <= 0 || height <= 0) return; // Minimized
+        if (width != m_Width || height != m_Height) Resize(width, height);
+
+        glBlitNamedFramebuffer(0, m_DepthFBO, viewport[0], viewport[1], viewport[0] + width, viewport[1] + height,
+            0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        const auto& shader = Services::GetAssetManager()->GetShader("hiz");
+        shader.Bind();
+        glBindTextureUnit(0, m_DepthCopy);
+
+        // Level 0 copies the depth, the others reduce the previous level
+        for (int level = 0; level < m_Levels; level++) {
+            const GLuint levelWidth  = std::max(1, width >> level);
+            const GLuint levelHeight = std::max(1, height >> level);
+            shader.SetInt("uLevel", level);
+            if (level > 0) glBindImageTexture(0, m_Pyramid, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindImageTexture(1, m_Pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            shader.Dispatch((levelWidth + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (levelHeight + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+        // Cull pass reads it with texelFetch
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by pointerlost on 1/11/26.
+//
+#include "Graphics/GPUArena.h"
+#include <algorithm>
+#include <format>
+
+namespace Real::opengl {
+
+    ArenaRange GPUArena::Allocate(GLsizeiptr capacity) {
+        if (m_Created) {
+            Warn("[GPUArena::Allocate] Ranges have to be allocated before Create!");
+            return {};
+        }
+        m_Ranges.push_back({ 0, std::max<GLsizeiptr>(capacity, 1) });
+        return { static_cast<uint32_t>(m_Ranges.size() - 1) };
+    }
+
+    void GPUArena::Create(uint32_t regionCount) {
+        GLint alignment = 256;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_Alignment = alignment;
+
+        const GLsizeiptr regionSize = Layout(m_Ranges);
+        m_Buffer.CreateRing(regionSize, regionCount);
+        m_Created = true;
+
+        Info(std::format("[GPUArena] {} ranges, {} bytes per region", m_Ranges.size(), m_Buffer.GetRegionSize()));
+    }
+
+    void GPUArena::BeginFrame() {
+        m_Buffer.BeginFrame();
+        m_DirtyBegin = m_DirtyEnd = 0;
+    }
+
+    void GPUArena::EndFrame() {
+        m_Buffer.EndFrame();
+    }
+
+    void GPUArena::Write(const ArenaRange &range, const void *data, GLintptr offset, GLsizeiptr size) {
+        if (!range.IsValid() || size <= 0) return;
+
+        if (offset + size > m_Ranges[range.m_Index].m_Capacity) {
+            GrowRange(range.m_Index, offset + size);
+        }
+
+        const GLintptr begin = m_Ranges[range.m_Index].m_Offset + offset;
+        m_Buffer.Write(data, begin, size);
+
+        // Extend the span which will be flushed
+        if (m_DirtyBegin == m_DirtyEnd) {
+            m_DirtyBegin = begin;
+            m_DirtyEnd   = begin + size;
+        } else {
+            m_DirtyBegin = std::min(m_DirtyBegin, begin);
+            m_DirtyEnd   = std::max(m_DirtyEnd, begin + size);
+        }
+    }
+
+    void GPUArena::Flush() {
+        if (m_DirtyBegin == m_DirtyEnd) return;
+        m_Buffer.FlushRange(m_DirtyBegin, m_DirtyEnd - m_DirtyBegin);
+        m_DirtyBegin = m_DirtyEnd = 0;
+    }
+
+    GLintptr GPUArena::GetOffset(const ArenaRange &range) const {
+        return m_Buffer.GetRegionOffset() + m_Ranges[range.m_Index].m_Offset;
+    }
+
+    GLsizeiptr GPUArena::Layout(std::vector<Allocation> &ranges) const {
+        GLsizeiptr offset = 0;
+        for (auto& range : ranges) {
+            range.m_Capacity = Align(range.m_Capacity);
+            range.m_Offset   = offset;
+            offset += range.m_Capacity;
+        }
+        return std::max<GLsizeiptr>(offset, m_Alignment);
+    }
+
+    void GPUArena::GrowRange(uint32_t index, GLsizeiptr requiredCapacity) {
+        // Copy reads the GPU side, so the writes of this frame have to be flushed first
+        Flush();
+
+        auto ranges = m_Ranges;
+        GLsizeiptr capacity = ranges[index].m_Capacity;
+        while (capacity < requiredCapacity) {
+            capacity *= 2;
+        }
+        ranges[index].m_Capacity = capacity;
+        const GLsizeiptr regionSize = Layout(ranges);
+
+        std::vector<BufferCopy> copies;
+        copies.reserve(ranges.size());
+        for (size_t i = 0; i < ranges.size(); i++) {
+            copies.push_back({ m_Ranges[i].m_Offset, ranges[i].m_Offset, m_Ranges[i].m_Capacity });
+        }
+
+        m_Buffer.Relayout(regionSize, copies);
+        m_Ranges = std::move(ranges);
+    }
+}
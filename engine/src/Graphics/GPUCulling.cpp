@@ -0,0 +1,134 @@
+//
+// Created by pointerlost on 1/14/26.
+//
+#include "Graphics/GPUCulling.h"
+#include <algorithm>
+#include <format>
+#include <vector>
+#include "Core/AssetManager.h"
+#include "Core/Logger.h"
+#include "Core/RealConfig.h"
+#include "Core/Services.h"
+#include "Graphics/RenderCommand.h"
+
+namespace Real::opengl {
+
+    static constexpr GLuint CULL_GROUP_SIZE = 64; // local_size_x of cull.comp
+
+    static void RecreateBuffer(GLuint& buffer, GLsizeiptr size) {
+        if (buffer != 0) glDeleteBuffers(1, &buffer);
+        glCreateBuffers(1, &buffer);
+        // GPU only, the CPU never touches the content
+        glNamedBufferStorage(buffer, size, nullptr, 0);
+    }
+
+    GPUCulling::~GPUCulling() {
+        const GLuint buffers[] = { m_ScratchCommands, m_Commands, m_EntityData, m_DrawCount, m_Visibility, m_Stats, m_StatsReadback };
+        glDeleteBuffers(7, buffers);
+    }
+
+    void GPUCulling::Init() {
+        m_SupportsDrawCount = GLAD_GL_VERSION_4_6 && glMultiDrawElementsIndirectCount != nullptr;
+        RecreateBuffer(m_DrawCount, sizeof(GLuint));
+        RecreateBuffer(m_Stats, sizeof(CullStats));
+
+        const std::vector<CullStats> zeroStats(GPU_FRAMES_IN_FLIGHT);
+        constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &m_StatsReadback);
+        glNamedBufferStorage(m_StatsReadback, GPU_FRAMES_IN_FLIGHT * sizeof(CullStats), zeroStats.data(), flags);
+        m_MappedStats = static_cast<const CullStats*>(
+            glMapNamedBufferRange(m_StatsReadback, 0, GPU_FRAMES_IN_FLIGHT * sizeof(CullStats), flags));
+        if (!m_MappedStats) Warn("[GPUCulling] Stats readback buffer couldn't be mapped!");
+
+        Reserve(GPU_ARENA_INITIAL_ELEMENTS, GPU_ARENA_INITIAL_ELEMENTS);
+        Info(std::format("[GPUCulling] Initialized ({})", m_SupportsDrawCount
+            ? "MultiDrawElementsIndirectCount" : "no draw count, culled commands are submitted empty"));
+    }
+
+    void GPUCulling::Reserve(uint32_t commandCount, uint32_t instanceCount) {
+        if (commandCount > m_CommandCapacity) {
+            m_CommandCapacity = std::max(commandCount, m_CommandCapacity * 2);
+            RecreateBuffer(m_ScratchCommands, m_CommandCapacity * sizeof(DrawElementsIndirectCommand));
+            RecreateBuffer(m_Commands, m_CommandCapacity * sizeof(DrawElementsIndirectCommand));
+        }
+        if (instanceCount > m_InstanceCapacity) {
+            m_InstanceCapacity = std::max(instanceCount, m_InstanceCapacity * 2);
+            RecreateBuffer(m_EntityData, m_InstanceCapacity * sizeof(EntityMetadata));
+            RecreateBuffer(m_Visibility, m_InstanceCapacity * sizeof(GLuint));
+            m_VisibilityVersion = UINT64_MAX;
+        }
+    }
+
+    void GPUCulling::SyncVisibility(uint64_t commandsVersion) {
+        if (commandsVersion == m_VisibilityVersion || m_Visibility == 0) return;
+        m_VisibilityVersion = commandsVersion;
+        // All visible, the first frame draws everything in the early pass
+        constexpr GLuint visible = 1;
+        glClearNamedBufferData(m_Visibility, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &visible);
+    }
+
+    void GPUCulling::Dispatch(uint32_t commandCount, uint32_t instanceCount, CullPhase phase) {
+        if (commandCount == 0) return;
+        Reserve(commandCount, instanceCount);
+        // No pyramid yet (minimized window), fall back to the frustum test
+        if (phase == CullPhase::LATE && !m_DepthPyramid.IsValid()) phase = CullPhase::FRUSTUM;
+
+        const auto& shader = Services::GetAssetManager()->GetShader("cull");
+        shader.Bind();
+        shader.SetUint("uCommandCount", commandCount);
+        shader.SetUint("uInstanceCount", instanceCount);
+        shader.SetInt("uPhase", static_cast<int>(phase));
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9,  m_ScratchCommands);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, m_EntityData);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, m_DrawCount);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 12, m_Commands);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 13, m_Visibility, 0, m_InstanceCapacity * sizeof(GLuint));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 14, m_Stats);
+        if (phase == CullPhase::LATE) m_DepthPyramid.Bind(0);
+
+        const auto Groups = [](uint32_t count) { return (count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE; };
+
+        // Reset, the instance counts are rebuilt by the cull pass
+        shader.SetInt("uPass", 0);
+        shader.Dispatch(Groups(commandCount));
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        shader.SetInt("uPass", 1);
+        shader.Dispatch(Groups(instanceCount));
+
+        if (m_SupportsDrawCount) {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            shader.SetInt("uPass", 2);
+            shader.Dispatch(Groups(commandCount));
+        }
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    void GPUCulling::BindForDraw() const {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_EntityData, 0, m_InstanceCapacity * sizeof(EntityMetadata));
+    }
+
+    void GPUCulling::Draw(uint32_t commandCount) const {
+        if (commandCount == 0) return;
+        if (m_SupportsDrawCount) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Commands);
+            glBindBuffer(GL_PARAMETER_BUFFER, m_DrawCount);
+            glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, static_cast<GLsizei>(commandCount), 0);
+        } else {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_ScratchCommands);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commandCount), 0);
+        }
+    }
+
+    CullStats GPUCulling::ReadStats(uint32_t region) const {
+        if (!m_MappedStats) return {};
+        return m_MappedStats[region];
+    }
+
+    void GPUCulling::CopyStats(uint32_t region) const {
+        // Counters are written by the cull pass, the copy reads them through the buffer update path
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glCopyNamedBufferSubData(m_Stats, m_StatsReadback, 0, region * sizeof(CullStats), sizeof(CullStats));
+    }
+}
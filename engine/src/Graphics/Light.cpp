@@ -2,7 +2,10 @@
 // Created by pointerlost on 10/10/25.
 //
 #include "Graphics/Light.h"
+#include <cmath>
+#include <limits>
 
+#include "Core/RealConfig.h"
 #include "Core/Services.h"
 #include "Core/Timer.h"
 #include "Graphics/Transformations.h"
@@ -21,11 +24,24 @@ namespace Real {
         LightSSBO gpuData{};                                          // Convert angles to cosine
         gpuData.pos_cutoff = glm::vec4(transform.GetTranslate(),      glm::cos(glm::radians(m_CutOff)));      // Inner cone
         gpuData.dir_outer  = glm::vec4(transform.GetWorldDirection(), glm::cos(glm::radians(m_OuterCutOff))); // Outer cone
-        gpuData.radiance   = glm::vec4(m_Radiance, 1.0); // w unused
+        gpuData.radiance   = glm::vec4(m_Radiance, GetRange());
         gpuData.constant   = m_Constant;
         gpuData.linear     = m_Linear;
         gpuData.quadratic  = m_Quadratic;
         gpuData.type       = static_cast<int>(m_Type);
         return gpuData;
     }
+
+    float Light::GetRange() const {
+        if (m_Type == LightType::DIRECTIONAL) return std::numeric_limits<float>::max();
+
+        // constant + linear * d + quadratic * d^2 = brightest channel / cutoff
+        const float brightest = glm::max(m_Radiance.r, glm::max(m_Radiance.g, m_Radiance.b));
+        const float target = brightest / LIGHT_ATTENUATION_CUTOFF - m_Constant;
+        if (target <= 0.0f) return 0.0f;
+        if (m_Quadratic > 0.0f)
+            return (-m_Linear + std::sqrt(m_Linear * m_Linear + 4.0f * m_Quadratic * target)) / (2.0f * m_Quadratic);
+        if (m_Linear > 0.0f) return target / m_Linear;
+        return std::numeric_limits<float>::max(); // No falloff
+    }
 }
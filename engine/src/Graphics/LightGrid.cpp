@@ -0,0 +1,148 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include "Graphics/LightGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Common/Scheduling/TaskManager.h"
+#include "Core/RealConfig.h"
+#include "Core/Services.h"
+#include "Graphics/Light.h"
+
+namespace Real {
+
+    static constexpr uint32_t CLUSTERS_PER_SLICE = LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y;
+
+    void LightGrid::Build(const CameraUBO& camera, const std::vector<LightSSBO>& lights,
+        std::vector<LightClusterSSBO>& clusters, std::vector<uint32_t>& lightIndices)
+    {
+        if (camera.projection != m_Projection) BuildClusterBounds(camera.projection);
+
+        // View space spheres, computed once and shared by all the slices
+        m_Lights.clear();
+        m_Lights.reserve(lights.size());
+        const glm::mat3 rotation(camera.view);
+        for (const auto& light : lights) {
+            LightBounds bounds{};
+            const float range = light.radiance.w;
+            const glm::vec3 position = camera.view * glm::vec4(glm::vec3(light.pos_cutoff), 1.0f);
+
+            if (light.type == static_cast<int>(LightType::DIRECTIONAL)) {
+                bounds.m_Infinite = true;
+            }
+            else if (light.type == static_cast<int>(LightType::SPOT)) {
+                // Bounding sphere of the cone (range long, outer cutoff wide)
+                const glm::vec3 direction = glm::normalize(rotation * glm::vec3(light.dir_outer));
+                const float cosOuter = glm::clamp(light.dir_outer.w, 0.0001f, 1.0f);
+                if (cosOuter < 0.70710678f) { // Wider than 45 degrees
+                    bounds.m_Center = position + direction * (range * cosOuter);
+                    bounds.m_Radius = range * std::sqrt(1.0f - cosOuter * cosOuter);
+                } else {
+                    bounds.m_Radius = range / (2.0f * cosOuter);
+                    bounds.m_Center = position + direction * bounds.m_Radius;
+                }
+            }
+            else {
+                bounds.m_Center = position;
+                bounds.m_Radius = range;
+            }
+            m_Lights.push_back(bounds);
+        }
+
+        clusters.assign(static_cast<size_t>(CLUSTERS_PER_SLICE) * LIGHT_CLUSTER_Z, {});
+        m_SliceIndices.resize(LIGHT_CLUSTER_Z);
+
+        const auto BinSlices = [this, &clusters](size_t begin, size_t end) {
+            for (size_t slice = begin; slice < end; slice++) BinSlice(static_cast<uint32_t>(slice), clusters);
+        };
+        if (auto* taskManager = Services::GetTaskManager(); taskManager && !m_Lights.empty()) {
+            taskManager->ParallelFor(LIGHT_CLUSTER_Z, BinSlices, 1);
+        } else {
+            BinSlices(0, LIGHT_CLUSTER_Z);
+        }
+
+        // Slices in order, the list is the same whatever the workers did
+        lightIndices.clear();
+        for (uint32_t slice = 0; slice < LIGHT_CLUSTER_Z; slice++) {
+            const auto base = static_cast<uint32_t>(lightIndices.size());
+            for (uint32_t i = 0; i < CLUSTERS_PER_SLICE; i++) {
+                clusters[slice * CLUSTERS_PER_SLICE + i].offset += base;
+            }
+            lightIndices.insert(lightIndices.end(), m_SliceIndices[slice].begin(), m_SliceIndices[slice].end());
+        }
+    }
+
+    void LightGrid::BuildClusterBounds(const glm::mat4& projection) {
+        m_Projection = projection;
+        // glm::perspective (OpenGL clip space), m[col][row]
+        m_Near = projection[3][2] / (projection[2][2] - 1.0f);
+        m_Far  = projection[3][2] / (projection[2][2] + 1.0f);
+        // Not a perspective projection (no camera yet), the grid is wrong but still valid
+        if (!(m_Near > 0.0f) || !(m_Far > m_Near)) {
+            m_Near = 0.1f;
+            m_Far  = 1000.0f;
+        }
+
+        m_Bounds.resize(static_cast<size_t>(CLUSTERS_PER_SLICE) * LIGHT_CLUSTER_Z);
+        for (uint32_t z = 0; z < LIGHT_CLUSTER_Z; z++) {
+            // Exponential slices, same formula as the fragment shader
+            const float sliceNear = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z) / LIGHT_CLUSTER_Z);
+            const float sliceFar  = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z + 1) / LIGHT_CLUSTER_Z);
+
+            for (uint32_t y = 0; y < LIGHT_CLUSTER_Y; y++) {
+                for (uint32_t x = 0; x < LIGHT_CLUSTER_X; x++) {
+                    const float ndcX[2] = { -1.0f + 2.0f * x / LIGHT_CLUSTER_X, -1.0f + 2.0f * (x + 1) / LIGHT_CLUSTER_X };
+                    const float ndcY[2] = { -1.0f + 2.0f * y / LIGHT_CLUSTER_Y, -1.0f + 2.0f * (y + 1) / LIGHT_CLUSTER_Y };
+
+                    ClusterBounds bounds{ glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest()) };
+                    for (const float depth : { sliceNear, sliceFar }) {
+                        for (const float nx : ndcX) {
+                            for (const float ny : ndcY) {
+                                // Back from the clip space at the view depth (w = depth)
+                                const glm::vec3 corner((nx + projection[2][0]) * depth / projection[0][0],
+                                                       (ny + projection[2][1]) * depth / projection[1][1], -depth);
+                                bounds.m_Min = glm::min(bounds.m_Min, corner);
+                                bounds.m_Max = glm::max(bounds.m_Max, corner);
+                            }
+                        }
+                    }
+                    m_Bounds[z * CLUSTERS_PER_SLICE + y * LIGHT_CLUSTER_X + x] = bounds;
+                }
+            }
+        }
+    }
+
+    void LightGrid::BinSlice(uint32_t slice, std::vector<LightClusterSSBO>& clusters) {
+        auto& indices = m_SliceIndices[slice];
+        indices.clear();
+
+        // Lights reaching the slice's depth range, the clusters only test these
+        const float sliceMinZ = m_Bounds[slice * CLUSTERS_PER_SLICE].m_Min.z;
+        const float sliceMaxZ = m_Bounds[slice * CLUSTERS_PER_SLICE].m_Max.z;
+        std::vector<uint32_t> sliceLights;
+        for (uint32_t i = 0; i < m_Lights.size(); i++) {
+            const auto& light = m_Lights[i];
+            if (light.m_Infinite || (light.m_Center.z + light.m_Radius >= sliceMinZ && light.m_Center.z - light.m_Radius <= sliceMaxZ))
+                sliceLights.push_back(i);
+        }
+
+        for (uint32_t cluster = 0; cluster < CLUSTERS_PER_SLICE; cluster++) {
+            const uint32_t index = slice * CLUSTERS_PER_SLICE + cluster;
+            const auto& bounds = m_Bounds[index];
+            clusters[index].offset = static_cast<uint32_t>(indices.size()); // Relative to the slice for now
+
+            for (const uint32_t lightIndex : sliceLights) {
+                const auto& light = m_Lights[lightIndex];
+                if (!light.m_Infinite) {
+                    // Sphere vs box, distance to the closest point
+                    const glm::vec3 closest = glm::clamp(light.m_Center, bounds.m_Min, bounds.m_Max);
+                    const glm::vec3 delta = closest - light.m_Center;
+                    if (glm::dot(delta, delta) > light.m_Radius * light.m_Radius) continue;
+                }
+                indices.push_back(lightIndex);
+            }
+            clusters[index].count = static_cast<uint32_t>(indices.size()) - clusters[index].offset;
+        }
+    }
+}
@@ -6,69 +6,214 @@
 #include "Core/Logger.h"
 #include "Core/Utils.h"
 #include "Graphics/MeshFactory.h"
+#include <algorithm>
+#include <format>
 #include <span>
 #include "Core/AssetManager.h"
+#include "Core/RealConfig.h"
 #include "Graphics/Material.h"
+#include "Math/Math.h"
 
 namespace Real {
 
     const MeshAsset* MeshData::GetMeshData(const UUID& uuid) const {
-        const auto it = m_MeshAssets.find(uuid);
-        if (it == m_MeshAssets.end()) {
+        const auto handle = GetMeshHandle(uuid);
+        if (!handle.IsValid()) {
             Warn("Mesh doesn't exist! UUID: " + std::to_string(uuid));
             return nullptr;
         }
-        return &it->second;
+        return m_MeshAssets.Get(handle);
+    }
+
+    MeshHandle MeshData::GetMeshHandle(const UUID &uuid) const {
+        const auto it = m_MeshHandles.find(uuid);
+        return it != m_MeshHandles.end() ? it->second : MeshHandle{};
     }
 
     const MeshAsset& MeshData::CreateSingleMesh(std::vector<Vertex> vertices,
         const std::vector<uint32_t>& indices, const UUID& meshUUID)
     {
-        if (m_MeshAssets.contains(meshUUID))
-            return m_MeshAssets[meshUUID]; // Skip if mesh already exists
+        const auto bounds = math::ComputeAABB(vertices);
+        return CreateSingleMesh(std::move(vertices), indices, meshUUID, bounds);
+    }
+
+    const MeshAsset& MeshData::CreateSingleMesh(std::vector<Vertex> vertices,
+        const std::vector<uint32_t>& indices, const UUID& meshUUID, const AABB& bounds)
+    {
+        if (const auto it = m_MeshHandles.find(meshUUID); it != m_MeshHandles.end())
+            return *m_MeshAssets.Get(it->second); // Skip if mesh already exists
+        return CreateSingleMesh(math::PackVertices(vertices, bounds), indices, meshUUID, bounds);
+    }
+
+    const MeshAsset& MeshData::CreateSingleMesh(std::span<const PackedVertex> vertices,
+        std::span<const uint32_t> indices, const UUID& meshUUID, const AABB& bounds)
+    {
+        if (const auto it = m_MeshHandles.find(meshUUID); it != m_MeshHandles.end())
+            return *m_MeshAssets.Get(it->second); // Skip if mesh already exists
         MeshAsset info{};
         info.m_MeshUUID     = meshUUID;
+        info.m_Bounds       = bounds;
 
         info.m_VertexCount  = vertices.size();
         info.m_IndexCount   = indices.size();
-        info.m_VertexOffset = m_AllVertices.size();
-        info.m_IndexOffset  = m_AllIndices.size();
+        info.m_VertexOffset = AllocateVertices(vertices.size());
+        info.m_IndexOffset  = AllocateIndices(indices.size());
 
-        m_AllVertices.insert(m_AllVertices.end(), vertices.begin(), vertices.end());
+        // Indices stay local, the draw command adds the vertex offset (baseVertex)
+        std::ranges::copy(vertices, m_AllVertices.begin() + static_cast<std::ptrdiff_t>(info.m_VertexOffset));
+        std::ranges::copy(indices, m_AllIndices.begin() + static_cast<std::ptrdiff_t>(info.m_IndexOffset));
+
+        // After InitResources, new meshes go to the GPU right away
+        UploadRange(m_VBO, info.m_VertexOffset * sizeof(PackedVertex), info.m_VertexCount * sizeof(PackedVertex),
+            m_AllVertices.data() + info.m_VertexOffset);
+        UploadRange(m_EBO, info.m_IndexOffset * sizeof(uint32_t), info.m_IndexCount * sizeof(uint32_t),
+            m_AllIndices.data() + info.m_IndexOffset);
+
+        const auto handle = m_MeshAssets.Insert(info);
+        m_MeshHandles[meshUUID] = handle;
+        WriteMeshTable(handle, bounds);
+        m_Version++;
+        return *m_MeshAssets.Get(handle);
+    }
 
-        for (const auto idx : indices) {
-            m_AllIndices.push_back(idx + info.m_VertexOffset);
+    void MeshData::WriteMeshTable(const MeshHandle &handle, const AABB &bounds) {
+        const bool grow = handle.m_Index >= m_MeshTable.size();
+        if (grow) {
+            m_MeshTable.resize(std::max<size_t>(m_MeshTable.size() * 2, handle.m_Index + 1));
         }
+        m_MeshTable[handle.m_Index] = { glm::vec4(bounds.m_Min, 0.0f), glm::vec4(bounds.m_Max - bounds.m_Min, 0.0f) };
 
-        return m_MeshAssets[meshUUID] = info;
+        if (m_MeshTableBuffer == 0) return;
+        if (grow) {
+            // Tiny buffer, recreating it is cheaper than keeping a spare capacity around
+            glDeleteBuffers(1, &m_MeshTableBuffer);
+            glCreateBuffers(1, &m_MeshTableBuffer);
+            glNamedBufferStorage(m_MeshTableBuffer, m_MeshTable.size() * sizeof(MeshGPUData), m_MeshTable.data(), GL_DYNAMIC_STORAGE_BIT);
+        } else {
+            UploadRange(m_MeshTableBuffer, handle.m_Index * sizeof(MeshGPUData), sizeof(MeshGPUData), &m_MeshTable[handle.m_Index]);
+        }
     }
 
-    std::span<const Vertex> MeshData::ViewVertices(const UUID& uuid) const {
-        if (!m_MeshAssets.contains(uuid)) return {};
+    bool MeshData::RemoveMesh(const UUID &meshUUID) {
+        const auto it = m_MeshHandles.find(meshUUID);
+        if (it == m_MeshHandles.end()) {
+            Warn("[MeshData::RemoveMesh] Mesh doesn't exist! UUID: " + std::to_string(meshUUID));
+            return false;
+        }
+
+        const auto* info = m_MeshAssets.Get(it->second);
+        m_VertexPool.Free(info->m_VertexOffset, info->m_VertexCount);
+        m_IndexPool.Free(info->m_IndexOffset, info->m_IndexCount);
+
+        if (it->second.m_Index < m_Meshlets.size())
+            m_Meshlets[it->second.m_Index].clear();
+
+        m_MeshAssets.Remove(it->second);
+        m_MeshHandles.erase(it);
+        m_Version++;
+        return true;
+    }
+
+    void MeshData::SetMeshlets(const UUID &meshUUID, std::vector<Meshlet> meshlets) {
+        const auto handle = GetMeshHandle(meshUUID);
+        if (!handle.IsValid()) {
+            Warn("[MeshData::SetMeshlets] Mesh doesn't exist! UUID: " + std::to_string(meshUUID));
+            return;
+        }
+        if (handle.m_Index >= m_Meshlets.size())
+            m_Meshlets.resize(handle.m_Index + 1);
+
+        m_Meshlets[handle.m_Index] = std::move(meshlets);
+        m_Version++;
+    }
+
+    std::span<const Meshlet> MeshData::GetMeshlets(const MeshHandle &handle) const {
+        if (!m_MeshAssets.Contains(handle) || handle.m_Index >= m_Meshlets.size()) return {};
+        return m_Meshlets[handle.m_Index];
+    }
+
+    uint64_t MeshData::AllocateVertices(uint64_t count) {
+        if (count == 0) return 0;
+        if (const auto offset = m_VertexPool.Allocate(count))
+            return *offset;
+
+        // Double the pool until it fits (at least one free range at the end is needed)
+        const uint64_t oldCapacity = m_VertexPool.GetCapacity();
+        uint64_t newCapacity = std::max<uint64_t>(oldCapacity * 2, MESH_POOL_MIN_VERTICES);
+        while (newCapacity - oldCapacity < count) newCapacity *= 2;
+
+        m_VertexPool.Grow(newCapacity);
+        m_AllVertices.resize(newCapacity);
+        if (m_VBO != 0) {
+            ResizeGPUBuffer(m_VBO, oldCapacity * sizeof(PackedVertex), newCapacity * sizeof(PackedVertex));
+            glVertexArrayVertexBuffer(m_UniversalVAO, 0, m_VBO, 0, sizeof(PackedVertex));
+        }
+        return *m_VertexPool.Allocate(count);
+    }
+
+    uint64_t MeshData::AllocateIndices(uint64_t count) {
+        if (count == 0) return 0;
+        if (const auto offset = m_IndexPool.Allocate(count))
+            return *offset;
+
+        const uint64_t oldCapacity = m_IndexPool.GetCapacity();
+        uint64_t newCapacity = std::max<uint64_t>(oldCapacity * 2, MESH_POOL_MIN_INDICES);
+        while (newCapacity - oldCapacity < count) newCapacity *= 2;
+
+        m_IndexPool.Grow(newCapacity);
+        m_AllIndices.resize(newCapacity);
+        if (m_EBO != 0) {
+            ResizeGPUBuffer(m_EBO, oldCapacity * sizeof(uint32_t), newCapacity * sizeof(uint32_t));
+            glVertexArrayElementBuffer(m_UniversalVAO, m_EBO);
+        }
+        return *m_IndexPool.Allocate(count);
+    }
+
+    void MeshData::ResizeGPUBuffer(GLuint &buffer, GLsizeiptr oldSize, GLsizeiptr newSize) {
+        GLuint newBuffer = 0;
+        glCreateBuffers(1, &newBuffer);
+        glNamedBufferStorage(newBuffer, newSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        if (buffer != 0) {
+            if (oldSize > 0)
+                glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, oldSize);
+            glDeleteBuffers(1, &buffer);
+        }
+        buffer = newBuffer;
+        Info(std::format("[MeshData] Mesh pool grew to {} bytes", newSize));
+    }
+
+    void MeshData::UploadRange(GLuint buffer, GLintptr offset, GLsizeiptr size, const void *data) const {
+        if (buffer == 0 || size <= 0) return;
+        glNamedBufferSubData(buffer, offset, size, data);
+    }
+
+    std::span<const PackedVertex> MeshData::ViewVertices(const UUID& uuid) const {
+        const auto* info = m_MeshAssets.Get(GetMeshHandle(uuid));
+        if (!info) return {};
 
-        const auto& info = m_MeshAssets.at(uuid);
         return {
-            m_AllVertices.data() + info.m_VertexOffset,
-            info.m_VertexCount
+            m_AllVertices.data() + info->m_VertexOffset,
+            info->m_VertexCount
         };
     }
 
     std::span<const uint32_t> MeshData::ViewIndices(const UUID& uuid) const {
-        if (!m_MeshAssets.contains(uuid)) return {};
+        const auto* info = m_MeshAssets.Get(GetMeshHandle(uuid));
+        if (!info) return {};
 
-        const auto& info = m_MeshAssets.at(uuid);
         return {
-            m_AllIndices.data() + info.m_IndexOffset,
-            info.m_IndexCount
+            m_AllIndices.data() + info->m_IndexOffset,
+            info->m_IndexCount
         };
     }
 
     const MeshAsset& MeshData::GetPrimitiveMeshData(const std::string &name) {
-        if (m_PrimitiveTypesUUIDs.contains(name)) {
+        if (!m_PrimitiveTypesUUIDs.contains(name)) {
             Warn("There is no primitive type with this name: " + name);
-            return m_MeshAssets[m_PrimitiveTypesUUIDs["triangle"]];
+            return *GetMeshData(m_PrimitiveTypesUUIDs["triangle"]);
         }
-        return m_MeshAssets[m_PrimitiveTypesUUIDs[name]];
+        return *GetMeshData(m_PrimitiveTypesUUIDs[name]);
     }
 
     const UUID& MeshData::GetPrimitiveUUID(const std::string &name) {
@@ -91,35 +236,50 @@ namespace Real {
     }
 
     void MeshData::InitResources() {
+        // Whole pools at once, meshes after this point are uploaded one by one
+        if (m_AllVertices.empty()) {
+            m_VertexPool.Grow(MESH_POOL_MIN_VERTICES);
+            m_AllVertices.resize(MESH_POOL_MIN_VERTICES);
+        }
+        if (m_AllIndices.empty()) {
+            m_IndexPool.Grow(MESH_POOL_MIN_INDICES);
+            m_AllIndices.resize(MESH_POOL_MIN_INDICES);
+        }
+
         glCreateBuffers(1, &m_VBO);
-        glNamedBufferData(m_VBO, m_AllVertices.size() * sizeof(Vertex), m_AllVertices.data(), GL_STATIC_DRAW);
+        glNamedBufferStorage(m_VBO, m_AllVertices.size() * sizeof(PackedVertex), m_AllVertices.data(), GL_DYNAMIC_STORAGE_BIT);
 
         glCreateBuffers(1, &m_EBO);
-        glNamedBufferData(m_EBO, m_AllIndices.size() * sizeof(uint32_t), m_AllIndices.data(), GL_STATIC_DRAW);
+        glNamedBufferStorage(m_EBO, m_AllIndices.size() * sizeof(uint32_t), m_AllIndices.data(), GL_DYNAMIC_STORAGE_BIT);
 
         // Create and bind global vao
         glCreateVertexArrays(1, &m_UniversalVAO);
 
         // Bind VBO to Current VAO
-        glVertexArrayVertexBuffer(m_UniversalVAO, 0, m_VBO, 0, sizeof(Vertex));
+        glVertexArrayVertexBuffer(m_UniversalVAO, 0, m_VBO, 0, sizeof(PackedVertex));
 
         // Bind EBO to VAO
         glVertexArrayElementBuffer(m_UniversalVAO, m_EBO);
 
-        // Position attribute
+        // Position attribute (normalized inside the mesh bounds, main.vert scales it back)
         glEnableVertexArrayAttrib(m_UniversalVAO, 0);
-        glVertexArrayAttribFormat(m_UniversalVAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, m_Position));
+        glVertexArrayAttribFormat(m_UniversalVAO, 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedVertex, m_Position));
         glVertexArrayAttribBinding(m_UniversalVAO, 0, 0);
 
-        // Normal attribute
+        // Normal attribute (octahedral)
         glEnableVertexArrayAttrib(m_UniversalVAO, 1);
-        glVertexArrayAttribFormat(m_UniversalVAO, 1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, m_Normal));
+        glVertexArrayAttribFormat(m_UniversalVAO, 1, 2, GL_SHORT, GL_TRUE, offsetof(PackedVertex, m_Normal));
         glVertexArrayAttribBinding(m_UniversalVAO, 1, 0);
 
         // UV attribute
         glEnableVertexArrayAttrib(m_UniversalVAO, 2);
-        glVertexArrayAttribFormat(m_UniversalVAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, m_UV));
+        glVertexArrayAttribFormat(m_UniversalVAO, 2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, m_UV));
         glVertexArrayAttribBinding(m_UniversalVAO, 2, 0);
+
+        // Mesh table, one entry per mesh handle
+        if (m_MeshTable.empty()) m_MeshTable.resize(1);
+        glCreateBuffers(1, &m_MeshTableBuffer);
+        glNamedBufferStorage(m_MeshTableBuffer, m_MeshTable.size() * sizeof(MeshGPUData), m_MeshTable.data(), GL_DYNAMIC_STORAGE_BIT);
     }
 
 }
@@ -0,0 +1,342 @@
+//
+// Created by pointerlost on 1/13/26.
+//
+#include "Graphics/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Real {
+
+    // FIFO post transform cache with timestamps, a vertex is cached if it was added in the last cacheSize misses
+    struct VertexCacheSim {
+        std::vector<uint32_t> m_Timestamps;
+        uint32_t m_CacheSize;
+        uint32_t m_Time;
+
+        VertexCacheSim(size_t vertexCount, uint32_t cacheSize)
+            : m_Timestamps(vertexCount, 0), m_CacheSize(cacheSize), m_Time(cacheSize + 1) {}
+
+        [[nodiscard]] bool IsCached(uint32_t v) const { return m_Time - m_Timestamps[v] <= m_CacheSize; }
+
+        // Returns true on a miss
+        bool Touch(uint32_t v) {
+            if (IsCached(v)) return false;
+            m_Timestamps[v] = m_Time++;
+            return true;
+        }
+
+        uint32_t TouchTriangle(const uint32_t* tri) {
+            return Touch(tri[0]) + Touch(tri[1]) + Touch(tri[2]);
+        }
+
+        // Everything looks evicted after this
+        void Flush() { m_Time += m_CacheSize + 1; }
+    };
+
+    static bool IsValidMesh(std::span<const uint32_t> indices, size_t vertexCount) {
+        if (indices.size() % 3 != 0) return false;
+        return std::ranges::all_of(indices, [vertexCount](uint32_t idx) { return idx < vertexCount; });
+    }
+
+    MeshOptimizeStats MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+        MeshOptimizeStats stats{};
+        stats.m_ACMRBefore = ComputeACMR(indices, vertices.size());
+        stats.m_ACMRAfter  = stats.m_ACMRBefore;
+        if (indices.empty() || !IsValidMesh(indices, vertices.size())) return stats;
+
+        std::vector<uint32_t> clusters;
+        const auto cacheOrder = OptimizeVertexCache(indices, vertices.size(), &clusters);
+        indices = OptimizeOverdraw(cacheOrder, vertices, clusters);
+        OptimizeVertexFetch(vertices, indices);
+
+        stats.m_ACMRAfter = ComputeACMR(indices, vertices.size());
+        return stats;
+    }
+
+    std::vector<uint32_t> MeshOptimizer::OptimizeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+        std::vector<uint32_t>* clusters, uint32_t cacheSize)
+    {
+        std::vector<uint32_t> out;
+        if (clusters) clusters->clear();
+        if (indices.empty() || !IsValidMesh(indices, vertexCount)) return { indices.begin(), indices.end() };
+        out.reserve(indices.size());
+
+        // Vertex -> triangles (CSR)
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (const auto idx : indices) offsets[idx + 1]++;
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++) {
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // Live triangle count per vertex
+        std::vector<uint32_t> live(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) live[v] = offsets[v + 1] - offsets[v];
+
+        VertexCacheSim cache(vertexCount, cacheSize);
+        std::vector<uint8_t> emitted(indices.size() / 3, 0);
+        std::vector<uint32_t> deadEnd;
+        std::vector<uint32_t> candidates;
+        deadEnd.reserve(indices.size());
+        size_t cursor = 0;
+
+        // Most recent vertex that still has triangles, otherwise the next one in input order
+        const auto SkipDeadEnd = [&]() -> int64_t {
+            while (!deadEnd.empty()) {
+                const uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) return v;
+            }
+            for (; cursor < vertexCount; cursor++) {
+                if (live[cursor] > 0) return static_cast<int64_t>(cursor);
+            }
+            return -1;
+        };
+
+        int64_t fan = SkipDeadEnd();
+        if (clusters && fan >= 0) clusters->push_back(0);
+
+        while (fan >= 0) {
+            // Emit every remaining triangle around the fanning vertex
+            candidates.clear();
+            for (uint32_t k = offsets[fan]; k < offsets[fan + 1]; k++) {
+                const uint32_t t = adjacency[k];
+                if (emitted[t]) continue;
+
+                for (uint32_t c = 0; c < 3; c++) {
+                    const uint32_t v = indices[t * 3 + c];
+                    out.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    cache.Touch(v);
+                }
+                emitted[t] = 1;
+            }
+
+            // Next fan is the oldest candidate that stays in the cache while its triangles are emitted
+            int64_t next = -1;
+            int64_t bestPriority = -1;
+            for (const uint32_t v : candidates) {
+                if (live[v] == 0) continue;
+
+                int64_t priority = 0;
+                const uint32_t age = cache.m_Time - cache.m_Timestamps[v];
+                if (age + 2 * live[v] <= cacheSize) priority = age;
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            if (next == -1) {
+                next = SkipDeadEnd();
+                // Locality is lost here, good place for an overdraw cluster boundary
+                if (clusters && next >= 0) clusters->push_back(static_cast<uint32_t>(out.size() / 3));
+            }
+            fan = next;
+        }
+        return out;
+    }
+
+    std::vector<uint32_t> MeshOptimizer::OptimizeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices,
+        std::span<const uint32_t> clusters, float threshold, uint32_t cacheSize)
+    {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || clusters.empty() || !IsValidMesh(indices, vertices.size()))
+            return { indices.begin(), indices.end() };
+
+        // Soft boundaries, a hard cluster is cut as soon as its running ACMR gets close to the whole cluster ACMR
+        std::vector<uint32_t> splits;
+        VertexCacheSim cache(vertices.size(), cacheSize);
+        for (size_t c = 0; c < clusters.size(); c++) {
+            const size_t begin = clusters[c];
+            const size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triCount;
+
+            cache.Flush();
+            uint32_t clusterMisses = 0;
+            for (size_t t = begin; t < end; t++) clusterMisses += cache.TouchTriangle(&indices[t * 3]);
+            const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            cache.Flush();
+            splits.push_back(static_cast<uint32_t>(begin));
+            uint32_t runningMisses = 0, runningTris = 0;
+            for (size_t t = begin; t < end; t++) {
+                runningMisses += cache.TouchTriangle(&indices[t * 3]);
+                runningTris++;
+                if (t + 1 < end && static_cast<float>(runningMisses) <= clusterThreshold * static_cast<float>(runningTris)) {
+                    splits.push_back(static_cast<uint32_t>(t + 1));
+                    cache.Flush();
+                    runningMisses = runningTris = 0;
+                }
+            }
+        }
+
+        // Area weighted centroid and normal per cluster
+        struct Cluster {
+            uint32_t m_Begin, m_End;
+            glm::vec3 m_Centroid{0.0f};
+            glm::vec3 m_Normal{0.0f};
+            float m_Area = 0.0f;
+            float m_SortKey = 0.0f;
+        };
+
+        std::vector<Cluster> sorted(splits.size());
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t c = 0; c < splits.size(); c++) {
+            auto& cluster = sorted[c];
+            cluster.m_Begin = splits[c];
+            cluster.m_End = c + 1 < splits.size() ? splits[c + 1] : static_cast<uint32_t>(triCount);
+
+            for (uint32_t t = cluster.m_Begin; t < cluster.m_End; t++) {
+                const auto& p0 = vertices[indices[t * 3 + 0]].m_Position;
+                const auto& p1 = vertices[indices[t * 3 + 1]].m_Position;
+                const auto& p2 = vertices[indices[t * 3 + 2]].m_Position;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float area = glm::length(n);
+
+                cluster.m_Centroid += (p0 + p1 + p2) * (area / 3.0f);
+                cluster.m_Normal += n;
+                cluster.m_Area += area;
+            }
+            meshCentroid += cluster.m_Centroid;
+            meshArea += cluster.m_Area;
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        // Clusters facing away from the center are likely to occlude the rest, they go first
+        for (auto& cluster : sorted) {
+            if (cluster.m_Area <= 0.0f) continue;
+            const glm::vec3 centroid = cluster.m_Centroid / cluster.m_Area;
+            const float normalLength = glm::length(cluster.m_Normal);
+            if (normalLength > 0.0f)
+                cluster.m_SortKey = glm::dot(centroid - meshCentroid, cluster.m_Normal / normalLength);
+        }
+        std::ranges::stable_sort(sorted, std::greater{}, &Cluster::m_SortKey);
+
+        std::vector<uint32_t> out;
+        out.reserve(indices.size());
+        for (const auto& cluster : sorted) {
+            out.insert(out.end(), indices.begin() + cluster.m_Begin * 3, indices.begin() + cluster.m_End * 3);
+        }
+        return out;
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+        constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+        if (!IsValidMesh(indices, vertices.size())) return;
+
+        std::vector<uint32_t> remap(vertices.size(), UNUSED);
+        std::vector<Vertex> out;
+        out.reserve(vertices.size());
+        for (auto& idx : indices) {
+            if (remap[idx] == UNUSED) {
+                remap[idx] = static_cast<uint32_t>(out.size());
+                out.push_back(vertices[idx]);
+            }
+            idx = remap[idx];
+        }
+        vertices = std::move(out);
+    }
+
+    std::vector<Meshlet> MeshOptimizer::BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+        uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || !IsValidMesh(indices, vertices.size())) return meshlets;
+
+        // Vertex -> last meshlet that used it (+1), counts the unique vertices without clearing
+        std::vector<uint32_t> owner(vertices.size(), 0);
+        std::vector<uint32_t> meshletVertices;
+        meshletVertices.reserve(maxVertices);
+
+        const auto Finish = [&](Meshlet& meshlet) {
+            // Sphere around the vertex bounds
+            glm::vec3 min = vertices[meshletVertices[0]].m_Position, max = min;
+            for (const auto v : meshletVertices) {
+                min = glm::min(min, vertices[v].m_Position);
+                max = glm::max(max, vertices[v].m_Position);
+            }
+            meshlet.m_Center = (min + max) * 0.5f;
+            for (const auto v : meshletVertices)
+                meshlet.m_Radius = std::max(meshlet.m_Radius, glm::length(vertices[v].m_Position - meshlet.m_Center));
+
+            // Normal cone, axis is the average face normal and the spread is the widest face from it
+            glm::vec3 axis(0.0f);
+            for (uint32_t i = meshlet.m_IndexOffset; i < meshlet.m_IndexOffset + meshlet.m_IndexCount; i += 3) {
+                const auto& p0 = vertices[indices[i + 0]].m_Position;
+                const auto& p1 = vertices[indices[i + 1]].m_Position;
+                const auto& p2 = vertices[indices[i + 2]].m_Position;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float len = glm::length(n);
+                if (len > 0.0f) axis += n / len;
+            }
+            const float axisLength = glm::length(axis);
+            if (axisLength <= 0.0f) return;
+            axis /= axisLength;
+
+            float minDot = 1.0f;
+            for (uint32_t i = meshlet.m_IndexOffset; i < meshlet.m_IndexOffset + meshlet.m_IndexCount; i += 3) {
+                const auto& p0 = vertices[indices[i + 0]].m_Position;
+                const auto& p1 = vertices[indices[i + 1]].m_Position;
+                const auto& p2 = vertices[indices[i + 2]].m_Position;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float len = glm::length(n);
+                if (len > 0.0f) minDot = std::min(minDot, glm::dot(axis, n / len));
+            }
+
+            meshlet.m_ConeAxis = axis;
+            // Faces wider than 90 degrees from the axis, some are always visible
+            meshlet.m_ConeCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+        };
+
+        Meshlet current{};
+        for (size_t t = 0; t < triCount; t++) {
+            const uint32_t* tri = &indices[t * 3];
+            const auto id = static_cast<uint32_t>(meshlets.size() + 1);
+            uint32_t newVertices = 0;
+            for (uint32_t c = 0; c < 3; c++) {
+                const bool repeated = (c > 0 && tri[c] == tri[0]) || (c == 2 && tri[2] == tri[1]);
+                if (!repeated && owner[tri[c]] != id) newVertices++;
+            }
+
+            if (current.m_IndexCount / 3 >= maxTriangles || meshletVertices.size() + newVertices > maxVertices) {
+                Finish(current);
+                meshlets.push_back(current);
+                current = {};
+                current.m_IndexOffset = static_cast<uint32_t>(t * 3);
+                meshletVertices.clear();
+            }
+
+            const auto owned = static_cast<uint32_t>(meshlets.size() + 1);
+            for (uint32_t c = 0; c < 3; c++) {
+                if (owner[tri[c]] == owned) continue;
+                owner[tri[c]] = owned;
+                meshletVertices.push_back(tri[c]);
+            }
+            current.m_IndexCount += 3;
+        }
+        Finish(current);
+        meshlets.push_back(current);
+        return meshlets;
+    }
+
+    float MeshOptimizer::ComputeACMR(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || !IsValidMesh(indices, vertexCount)) return 0.0f;
+
+        VertexCacheSim cache(vertexCount, cacheSize);
+        uint32_t misses = 0;
+        for (size_t t = 0; t < triCount; t++) misses += cache.TouchTriangle(&indices[t * 3]);
+        return static_cast<float>(misses) / static_cast<float>(triCount);
+    }
+}
@@ -2,6 +2,8 @@
 // Created by pointerlost on 12/4/25.
 //
 #include <Graphics/ModelLoader.h>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <utility>
 #include <assimp/Importer.hpp>
@@ -15,12 +17,30 @@
 #include "Core/Services.h"
 #include "Graphics/Material.h"
 #include "Graphics/Model.h"
+#include "Math/Math.h"
 #include "Serialization/Binary.h"
+#include "Common/Scheduling/TaskManager.h"
 #include "Tools/ImageTools.h"
+#include "Util/Hash.h"
 #include "Util/Util.h"
 
 namespace Real {
 
+    // Flags for complex models
+    static constexpr unsigned int MODEL_IMPORT_FLAGS =
+        aiProcess_Triangulate |
+        aiProcess_GenSmoothNormals |
+        aiProcess_FlipUVs |
+        aiProcess_JoinIdenticalVertices;
+    // Cache locality is handled by MeshOptimizer for every format (ExtractMesh)
+
+    // TODO: I'll add this flag when I add tangents and bitangents!
+    // aiProcess_CalcTangentSpace |      /* For normal mapping */
+
+    // Defined here because of the incomplete Assimp::Importer in the header
+    ModelImportContext::ModelImportContext() = default;
+    ModelImportContext::~ModelImportContext() = default;
+
     void ModelLoader::LoadAll(const std::string &rootDir) {
         namespace std_fs = std::filesystem;
         const auto& am = Services::GetAssetManager();
@@ -46,100 +66,296 @@ namespace Real {
             ".webp"
         };
 
+        // Content hashes of the new folders' model files, the import doesn't hash them again
+        std::unordered_map<std::string, uint64_t> sourceHashes;
         for (const auto& entry : std_fs::directory_iterator(rootDir)) {
-            if (entry.is_directory() && !am->IsModelExist(entry.path().filename().string())) {
-                modelFolders.push_back(entry.path());
+            const auto name = entry.path().filename().string();
+            if (!entry.is_directory() || am->IsModelExist(name)) continue;
+
+            // Renamed or copied folder, the models cooked from the same files are reused
+            std::vector<std::string> files;
+            for (const auto& file : std_fs::recursive_directory_iterator(entry.path())) {
+                if (file.is_regular_file() && IsModelFile(file.path())) files.push_back(file.path().string());
+            }
+            std::ranges::sort(files);
+            std::vector<uint64_t> hashes;
+            for (const auto& file : files) {
+                hashes.push_back(sourceHashes[file] = HashSource(file));
             }
+            if (!files.empty() && Services::GetAssetImporter()->ReuseCookedModels(name, files, hashes)) continue;
+
+            modelFolders.push_back(entry.path());
         }
+        // directory_iterator order is unspecified, sort it to keep the UUID/offset assignment stable
+        std::ranges::sort(modelFolders);
+
+        const auto start = std::chrono::steady_clock::now();
 
-        for (const auto& folder : modelFolders) {
-            // Clear and rebuild texture index for this model folder
-            m_TextureIndex.clear();
+        // Every folder is read by its own Assimp importer on a worker (pure CPU, no engine state)
+        std::vector<std::vector<Scope<ModelImportContext>>> folderContexts(modelFolders.size());
+        const auto ReadFolder = [&](size_t folderIdx) {
+            const auto& folder = modelFolders[folderIdx];
+            std::unordered_map<std::string, std::vector<std_fs::path>> textureIndex;
             std::vector<std::string> modelsPath;
             const auto& modelName = folder.filename().string();
 
             for (const auto& entry : std_fs::recursive_directory_iterator(folder)) {
 
                 if (entry.is_regular_file() && IsModelFile(entry.path())) {
-                    m_CurrentDirectory = entry.path().parent_path().string();
                     modelsPath.push_back(entry.path().string());
                 }
                 else if (entry.is_regular_file()) {
                     if (extensions.contains(entry.path().extension())) {
-                        m_TextureIndex[entry.path().stem().string()].push_back(entry.path());
+                        textureIndex[entry.path().stem().string()].push_back(entry.path());
                     }
                 }
             }
+            std::ranges::sort(modelsPath);
 
             for (const auto& modelPath : modelsPath) {
-                if (IsModelFile(modelPath)) {
-                    // Build texture index from this model's directory
-                    std::filesystem::path modelDir = std::filesystem::path(modelPath).parent_path();
-                    for (const auto& entry : std_fs::directory_iterator(modelDir)) {
-                        if (entry.is_regular_file() && extensions.contains(entry.path().extension())) {
-                            m_TextureIndex[entry.path().stem().string()].push_back(entry.path());
-                        }
+                // Build texture index from this model's directory
+                std::filesystem::path modelDir = std::filesystem::path(modelPath).parent_path();
+                for (const auto& entry : std_fs::directory_iterator(modelDir)) {
+                    if (entry.is_regular_file() && extensions.contains(entry.path().extension())) {
+                        textureIndex[entry.path().stem().string()].push_back(entry.path());
                     }
+                }
 
-                    // Check subdirectories
-                    for (const auto& entry : std_fs::recursive_directory_iterator(modelDir)) {
-                        if (entry.is_regular_file() && extensions.contains(entry.path().extension())) {
-                            m_TextureIndex[entry.path().stem().string()].push_back(entry.path());
-                        }
+                // Check subdirectories
+                for (const auto& entry : std_fs::recursive_directory_iterator(modelDir)) {
+                    if (entry.is_regular_file() && extensions.contains(entry.path().extension())) {
+                        textureIndex[entry.path().stem().string()].push_back(entry.path());
                     }
+                }
 
-                    m_CurrentDirectory = modelDir.string();
+                auto ctx = CreateScope<ModelImportContext>();
+                ctx->m_FilePath     = modelPath;
+                ctx->m_Name         = modelName;
+                ctx->m_Directory    = modelDir.string();
+                ctx->m_IsFBX        = modelPath.substr(modelPath.size() - 4) == ".fbx";
+                ctx->m_TextureIndex = textureIndex;
+                ctx->m_SourceHash   = sourceHashes.at(modelPath);
 
-                    if (modelPath.substr(modelPath.size() - 4) == ".fbx")
-                        m_IsFBX = true;
-                    Load(modelPath, modelName, ImageFormatState::COMPRESS_ME);
-                    m_IsFBX = false;
+                if (ReadScene(*ctx))
+                    folderContexts[folderIdx].push_back(std::move(ctx));
+            }
+        };
+
+        if (const auto& tm = Services::GetTaskManager()) {
+            tm->ParallelFor(modelFolders.size(), [&ReadFolder](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    ReadFolder(i);
+                }
+            }, 1);
+        } else {
+            for (size_t i = 0; i < modelFolders.size(); i++) {
+                ReadFolder(i);
+            }
+        }
+
+        // First import with enough small meshes trains the dictionary, the binaries of this batch already use it
+        if (MESH_BINARY_COMPRESSION && !serialization::binary::HasMeshDictionary()) {
+            std::vector<std::vector<uint8_t>> samples;
+            for (const auto& contexts : folderContexts) {
+                for (const auto& ctx : contexts) {
+                    for (const auto& mesh : ctx->m_Meshes) {
+                        const size_t vertexBytes = mesh.m_Vertices.size() * sizeof(PackedVertex);
+                        const size_t indexBytes  = mesh.m_Indices.size() * sizeof(uint32_t);
+                        if (vertexBytes + indexBytes > MESH_DICTIONARY_MAX_PAYLOAD) continue;
+
+                        // Same bytes as the compact binary payload
+                        const auto packed = math::PackVertices(mesh.m_Vertices, math::ToAABB(mesh.m_Header));
+                        auto& sample = samples.emplace_back(vertexBytes + indexBytes);
+                        std::memcpy(sample.data(), packed.data(), vertexBytes);
+                        std::memcpy(sample.data() + vertexBytes, mesh.m_Indices.data(), indexBytes);
+                    }
                 }
             }
+            serialization::binary::TrainMeshDictionary(samples);
         }
+
+        const auto readEnd = std::chrono::steady_clock::now();
+
+        // Registration goes in sorted folder order on the main thread
+        size_t modelCount = 0;
+        for (auto& contexts : folderContexts) {
+            for (auto& ctx : contexts) {
+                CommitModel(*ctx, ImageFormatState::COMPRESS_ME);
+                modelCount++;
+            }
+            // Release the assimp scenes of this folder
+            contexts.clear();
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        Info(std::format("[ModelLoader] Loaded {} models in {:.1f} ms (read {:.1f} ms, commit {:.1f} ms)", modelCount,
+            std::chrono::duration<double, std::milli>(end - start).count(),
+            std::chrono::duration<double, std::milli>(readEnd - start).count(),
+            std::chrono::duration<double, std::milli>(end - readEnd).count()
+        ));
     }
 
-    Ref<Model> ModelLoader::Load(const std::string &filePath, const std::string& name, const ImageFormatState state) {
+    Ref<Model> ModelLoader::Load(const std::string &filePath, const std::string& name, const ImageFormatState state,
+        const VertexFormat vertexFormat)
+    {
         if (!fs::File::Exists(filePath)) {
             Warn("Model file not found: " + filePath);
             return nullptr;
         }
-        // Reset state
-        m_CurrentModel = CreateRef<Model>();
-        m_CurrentModel->m_Name = name;
-        m_CurrImageFormatState = state;
-        m_CurrentModel->m_FileInfo = fs::CreateFileInfoFromPath(filePath);
 
-        // Create assimp importer
-        Assimp::Importer importer;
+        ModelImportContext ctx;
+        ctx.m_FilePath  = filePath;
+        ctx.m_Name      = name;
+        ctx.m_Directory = std::filesystem::path(filePath).parent_path().string();
+        ctx.m_IsFBX     = filePath.size() > 4 && filePath.substr(filePath.size() - 4) == ".fbx";
+        ctx.m_VertexFormat = vertexFormat;
+        ctx.m_SourceHash   = HashSource(filePath, vertexFormat);
 
-        // Flags for complex models
-        unsigned int importFlags =
-            aiProcess_Triangulate |
-            aiProcess_GenSmoothNormals |
-            aiProcess_FlipUVs |
-            aiProcess_JoinIdenticalVertices |
-            aiProcess_ImproveCacheLocality;   // Better performance
+        if (!ReadScene(ctx))
+            return nullptr;
+
+        return CommitModel(ctx, state);
+    }
+
+    uint64_t ModelLoader::HashSettings(VertexFormat vertexFormat) {
+        // Everything changing the cooked meshes goes in
+        const uint64_t settings[] = {
+            MODEL_IMPORT_FLAGS, MESH_BINARY_VERSION, MESH_BINARY_COMPRESSION, static_cast<uint64_t>(vertexFormat),
+            MESH_VERTEX_CACHE_SIZE, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, MESHLET_MIN_MESH_TRIANGLES
+        };
+        const uint64_t key = util::XXH64(settings, sizeof(settings));
+        return key != 0 ? key : 1; // 0 means unknown
+    }
 
-        // TODO: I'll add this flag when I add tangents and bitangents!
-        // aiProcess_CalcTangentSpace |      /* For normal mapping */
+    uint64_t ModelLoader::HashSource(const std::string &filePath, VertexFormat vertexFormat) {
+        uint64_t hash = 0;
+        if (!util::TryHashFile(filePath, hash, HashSettings(vertexFormat)))
+            return 0;
+        return hash != 0 ? hash : 1; // 0 means unknown
+    }
 
-        if (m_IsFBX) { // Need some optimization because .fbx models are slower than gltf or something
-            importFlags &= ~aiProcess_ImproveCacheLocality;
+    bool ModelLoader::ReadScene(ModelImportContext &ctx) {
+        if (!fs::File::Exists(ctx.m_FilePath)) {
+            Warn("Model file not found: " + ctx.m_FilePath);
+            return false;
         }
 
+        // Assimp importer is not thread-safe, every context has its own
+        ctx.m_Importer = CreateScope<Assimp::Importer>();
+
         // Load the scene
-        const aiScene* scene = importer.ReadFile(filePath, importFlags);
+        ctx.m_Scene = ctx.m_Importer->ReadFile(ctx.m_FilePath, MODEL_IMPORT_FLAGS);
 
         // Check for errors
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            Warn(std::format("Failed to load model: {} - {}", filePath, importer.GetErrorString()));
-            return nullptr;
+        if (!ctx.m_Scene || ctx.m_Scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !ctx.m_Scene->mRootNode) {
+            Warn(std::format("Failed to load model: {} - {}", ctx.m_FilePath, ctx.m_Importer->GetErrorString()));
+            return false;
         }
 
-        // Start processing from root node
+        // Flatten the node tree, meshes keep the node traversal order
+        std::vector<std::pair<const aiMesh*, aiMatrix4x4>> nodeMeshes;
         const aiMatrix4x4 identity;
-        ProcessNode(scene->mRootNode, scene, identity);
+        CollectNodeMeshes(ctx.m_Scene->mRootNode, ctx.m_Scene, identity, nodeMeshes);
+
+        ctx.m_Meshes.resize(nodeMeshes.size());
+        const auto Extract = [&](size_t i) {
+            const auto& [mesh, transform] = nodeMeshes[i];
+            ExtractMesh(mesh, transform, ctx.m_Meshes[i]);
+        };
+
+        if (const auto& tm = Services::GetTaskManager()) {
+            tm->ParallelFor(nodeMeshes.size(), [&Extract](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    Extract(i);
+                }
+            });
+        } else {
+            for (size_t i = 0; i < nodeMeshes.size(); i++) {
+                Extract(i);
+            }
+        }
+        return true;
+    }
+
+    Ref<Model> ModelLoader::CommitModel(ModelImportContext &ctx, ImageFormatState state) {
+        const auto& mm = Services::GetMeshManager();
+        const auto& ai = Services::GetAssetImporter();
+
+        // Reset state
+        m_CurrentModel = CreateRef<Model>();
+        m_CurrentModel->m_Name = ctx.m_Name;
+        m_CurrImageFormatState = state;
+        m_CurrentModel->m_FileInfo = fs::CreateFileInfoFromPath(ctx.m_FilePath);
+        m_CurrentDirectory = ctx.m_Directory;
+        if (!ctx.m_TextureIndex.empty()) {
+            m_TextureIndex = std::move(ctx.m_TextureIndex);
+        }
+
+        // Materials, UUIDs and offsets are assigned serially so the result doesn't depend on the workers
+        for (auto& mesh : ctx.m_Meshes) {
+            auto materialUUID = UUID(0); // TODO: i need to create default material fallback
+            if (mesh.m_MaterialIndex < ctx.m_Scene->mNumMaterials) {
+                const aiMaterial* material = ctx.m_Scene->mMaterials[mesh.m_MaterialIndex];
+                const Ref<Material> real_material = ProcessMaterial(material, (int)mesh.m_MaterialIndex);
+                materialUUID = real_material ? real_material->m_UUID : materialUUID;
+            }
+
+            // Offsets come from the pool allocator, freed ranges are reused so they're not appended anymore
+            const auto& asset = mm->CreateSingleMesh(mesh.m_Vertices, mesh.m_Indices, UUID{}, math::ToAABB(mesh.m_Header));
+            const UUID meshUUID = asset.m_MeshUUID;
+            const auto vertexOffset = asset.m_VertexOffset;
+            const auto indexOffset  = asset.m_IndexOffset;
+            m_CurrentModel->m_MeshUUIDs.push_back(meshUUID);
+            if (!mesh.m_Meshlets.empty())
+                mm->SetMeshlets(meshUUID, mesh.m_Meshlets);
+            m_CurrentModel->m_MaterialAssetUUIDs.push_back(materialUUID);
+
+            auto& header = mesh.m_Header;
+            header.m_Magic        = REAL_MAGIC;
+            header.m_Version      = MESH_BINARY_VERSION;
+            header.m_UUID         = meshUUID;
+            header.m_MaterialUUID = materialUUID;
+            header.m_VertexCount  = mesh.m_Vertices.size();
+            header.m_IndexCount   = mesh.m_Indices.size();
+            header.m_VertexOffset = vertexOffset;
+            header.m_IndexOffset  = indexOffset;
+            header.m_VertexFormat = ctx.m_VertexFormat;
+
+            Info(std::format("[ModelLoader] {} mesh {}: ACMR {:.3f} -> {:.3f} ({} triangles)", ctx.m_Name,
+                m_CurrentModel->m_MeshUUIDs.size() - 1, mesh.m_OptimizeStats.m_ACMRBefore,
+                mesh.m_OptimizeStats.m_ACMRAfter, mesh.m_Indices.size() / 3));
+        }
+
+        // Mesh binaries are independent files
+        // Compact binaries reuse the packed copy in the mesh pool, nothing is written to it until the loop ends
+        const auto WriteMeshBinary = [&ctx, &mm](size_t i) {
+            const auto& mesh = ctx.m_Meshes[i];
+            const auto& mBinaryPath = std::string(ASSETS_RUNTIME_DIR) + "meshes/" + std::to_string(mesh.m_Header.m_UUID) + ".mesh";
+            if (mesh.m_Header.m_VertexFormat == VertexFormat::COMPACT)
+                serialization::binary::WriteMesh(mBinaryPath, mesh.m_Header, mm->ViewVertices(UUID{mesh.m_Header.m_UUID}), mesh.m_Indices);
+            else
+                serialization::binary::WriteMesh(mBinaryPath, mesh.m_Header, mesh.m_Vertices, mesh.m_Indices);
+
+            if (!mesh.m_Meshlets.empty())
+                serialization::binary::WriteMeshlets(serialization::binary::MeshletPath(mBinaryPath),
+                    UUID{mesh.m_Header.m_UUID}, mesh.m_Meshlets);
+        };
+
+        if (const auto& tm = Services::GetTaskManager()) {
+            tm->ParallelFor(ctx.m_Meshes.size(), [&WriteMeshBinary](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    WriteMeshBinary(i);
+                }
+            });
+        } else {
+            for (size_t i = 0; i < ctx.m_Meshes.size(); i++) {
+                WriteMeshBinary(i);
+            }
+        }
+
+        for (const auto& mesh : ctx.m_Meshes) {
+            ai->SaveMeshToAssetDB(mesh.m_Header, std::to_string(mesh.m_Header.m_UUID));
+        }
 
         const auto& binary_path = std::string(ASSETS_RUNTIME_DIR) + "models/" + m_CurrentModel->m_Name + ".model";
 
@@ -157,40 +373,31 @@ namespace Real {
             m_CurrentModel->m_MaterialAssetUUIDs
         );
         Services::GetAssetManager()->SaveModelCPU(m_CurrentModel);
-        Services::GetAssetImporter()->SaveModelToAssetDB(m_CurrentModel);
+        ai->SaveModelToAssetDB(m_CurrentModel, ctx.m_SourceHash);
 
         return m_CurrentModel;
     }
 
-    void ModelLoader::ProcessNode(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parentTransform) {
+    void ModelLoader::CollectNodeMeshes(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parentTransform,
+        std::vector<std::pair<const aiMesh*, aiMatrix4x4>>& out)
+    {
         const aiMatrix4x4 globalTransform = parentTransform * node->mTransformation;
 
-        // Process all meshes in this node
+        // Collect all meshes in this node
         for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-            const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            ProcessMesh(mesh, scene, globalTransform);
+            out.emplace_back(scene->mMeshes[node->mMeshes[i]], globalTransform);
         }
 
-        // Process all children nodes
+        // Collect all children nodes
         for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            ProcessNode(node->mChildren[i], scene, globalTransform);
+            CollectNodeMeshes(node->mChildren[i], scene, globalTransform, out);
         }
     }
 
-    void ModelLoader::ProcessMesh(const aiMesh *mesh, const aiScene *scene, const aiMatrix4x4& transform) {
-        const auto& mm = Services::GetMeshManager();
-        // Create containers for vertex data
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
-
-        auto materialUUID = UUID(0); // TODO: i need to create default material fallback
-        if (mesh->mMaterialIndex >= 0) {
-            const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            Ref<Material> real_material;
-
-            real_material = ProcessMaterial(material, (int)mesh->mMaterialIndex);
-            materialUUID = real_material ? real_material->m_UUID : materialUUID;
-        }
+    void ModelLoader::ExtractMesh(const aiMesh *mesh, const aiMatrix4x4& transform, ImportedMesh& out) {
+        auto& vertices = out.m_Vertices;
+        auto& indices  = out.m_Indices;
+        out.m_MaterialIndex = mesh->mMaterialIndex;
 
         aiMatrix3x3 normalMat(transform);
         normalMat.Inverse().Transpose();
@@ -229,6 +436,7 @@ namespace Real {
         }
 
         // Process indices
+        indices.reserve(mesh->mNumFaces * 3);
         for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
             const aiFace face = mesh->mFaces[i];
             for (unsigned int j = 0; j < face.mNumIndices; j++) {
@@ -236,28 +444,13 @@ namespace Real {
             }
         }
 
-        // Get offsets before creation current meshes
-        const auto vertexOffset = mm->GetVerticesCount();
-        const auto indexOffset  = mm->GetIndicesCount();
-
-        const UUID meshUUID = Services::GetMeshManager()->CreateSingleMesh(vertices, indices, UUID{}).m_MeshUUID;
-        m_CurrentModel->m_MeshUUIDs.push_back(meshUUID);
-        m_CurrentModel->m_MaterialAssetUUIDs.push_back(materialUUID);
-
-        MeshBinaryHeader header;
-        header.m_Magic        = REAL_MAGIC;
-        header.m_Version      = 1;
-        header.m_UUID         = meshUUID;
-        header.m_MaterialUUID = materialUUID;
-        header.m_VertexCount  = vertices.size();
-        header.m_IndexCount   = indices.size();
-        header.m_VertexOffset = vertexOffset;
-        header.m_IndexOffset  = indexOffset;
-
-        const auto meshNameAsUUID = std::to_string(meshUUID);
-        const auto& mBinaryPath = std::string(ASSETS_RUNTIME_DIR) + "meshes/" + meshNameAsUUID + ".mesh";
-        serialization::binary::WriteMesh(mBinaryPath, header, vertices, indices);
-        Services::GetAssetImporter()->SaveMeshToAssetDB(header, meshNameAsUUID);
+        // Vertex cache, overdraw and vertex fetch order
+        out.m_OptimizeStats = MeshOptimizer::Optimize(vertices, indices);
+        if (indices.size() / 3 >= MESHLET_MIN_MESH_TRIANGLES)
+            out.m_Meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+
+        // Bounds go to the mesh binary, so they are computed only once at import
+        math::WriteAABB(math::ComputeAABB(vertices), out.m_Header);
     }
 
     Ref<Material> ModelLoader::ProcessMaterial(const aiMaterial *mat, int materialIndex) {
@@ -427,7 +620,7 @@ namespace Real {
             const auto mtl = pack[2] ? pack[2] : am->GetOrCreateDefaultTexture(TextureType::METALLIC);
             const auto orm = tools::PackTexturesToRGBChannels({ao, rgh, mtl}, material->m_Name);
             if (orm && orm->GetImageFormatState() != ImageFormatState::DEFAULT) {
-                tools::CompressTextureAndReadFromFile(orm.get());
+                Services::GetAssetImporter()->QueueCompression(orm);
                 material->m_ORM = orm->GetUUID();
             }
         }
@@ -448,8 +641,8 @@ namespace Real {
     void ModelLoader::SaveModelTextureAsFile(const Ref<OpenGLTexture>& tex) {
         if (tex->GetImageFormatState() != ImageFormatState::DEFAULT) {
             tools::SaveTextureAsFile(tex.get());
-            tools::CompressTextureAndReadFromFile(tex.get());
-            // Save after compression to use compressed data
+            // Compressed data is filled in place when the importer flushes the queue
+            Services::GetAssetImporter()->QueueCompression(tex);
             Services::GetAssetManager()->SaveTextureCPU(tex);
         }
     }
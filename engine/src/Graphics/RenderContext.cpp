@@ -2,7 +2,12 @@
 // Created by pointerlost on 10/13/25.
 //
 #include "Graphics/RenderContext.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
 
+#include "Common/Scheduling/TaskManager.h"
 #include "Core/AssetManager.h"
 #include "Core/Services.h"
 #include "Editor/EditorState.h"
@@ -14,218 +19,612 @@
 #include "Util/Util.h"
 #include "Common/RealEnum.h"
 #include "Graphics/Model.h"
+#include "Math/Frustum.h"
+#include "Math/Math.h"
 
 namespace Real {
 
     RenderContext::RenderContext(Scene *scene) : m_Scene(scene)
     {
+        // Draw commands are rebuilt only when the scene structure changed
+        auto& registry = m_Scene->GetRegistry();
+        registry.on_construct<TransformComponent>().connect<&RenderContext::OnStructureChanged>(this);
+        registry.on_destroy<TransformComponent>().connect<&RenderContext::OnTransformDestroyed>(this);
+        registry.on_construct<MeshRendererComponent>().connect<&RenderContext::OnStructureChanged>(this);
+        registry.on_update<MeshRendererComponent>().connect<&RenderContext::OnStructureChanged>(this);
+        registry.on_destroy<MeshRendererComponent>().connect<&RenderContext::OnStructureChanged>(this);
     }
 
     void RenderContext::InitResources() {
-        m_Buffers.transform.Create(m_GPUDatas.transforms,
-            MAX_ENTITIES * sizeof(TransformSSBO), BufferType::SSBO
-        );
-
-        m_Buffers.texture.Create(m_GPUDatas.textures,
+        const auto& front = GetGPURenderData();
+
+        // Start small, the ranges grow on demand (transform slots are capped by MAX_ENTITIES anyway)
+        auto& arena = m_Buffers.arena;
+        m_Buffers.drawCommand = arena.Allocate(GPU_ARENA_INITIAL_ELEMENTS * sizeof(DrawElementsIndirectCommand));
+        m_Buffers.entityData  = arena.Allocate(GPU_ARENA_INITIAL_ELEMENTS * sizeof(EntityMetadata));
+        m_Buffers.transform   = arena.Allocate(GPU_ARENA_INITIAL_ELEMENTS * sizeof(TransformSSBO));
+        m_Buffers.material    = arena.Allocate(GPU_ARENA_INITIAL_ELEMENTS * sizeof(MaterialSSBO));
+        m_Buffers.light       = arena.Allocate(MAX_LIGHTS * sizeof(LightSSBO));
+        m_Buffers.lightCluster = arena.Allocate(LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z * sizeof(LightClusterSSBO));
+        m_Buffers.lightIndex   = arena.Allocate(GPU_ARENA_INITIAL_ELEMENTS * sizeof(uint32_t));
+        arena.Create();
+
+        m_Buffers.texture.Create(front.textures,
             MAX_ENTITIES * sizeof(GLuint64), BufferType::SSBO
         );
-        m_Buffers.texture.UploadToGPU(m_GPUDatas.textures,
-            m_GPUDatas.textures.size() * sizeof(GLuint64), BufferType::SSBO
+        m_Buffers.texture.UploadToGPU(front.textures,
+            front.textures.size() * sizeof(GLuint64), BufferType::SSBO
         );
 
-        m_Buffers.material.Create(m_GPUDatas.materials,
-            MAX_ENTITIES * sizeof(MaterialSSBO), BufferType::SSBO
-        );
+        m_Buffers.camera.Create(front.camera, 1 * sizeof(CameraUBO), BufferType::UBO);
 
-        m_Buffers.light.Create(m_GPUDatas.lights,
-            MAX_LIGHTS * sizeof(LightSSBO), BufferType::SSBO
-        );
+        m_Buffers.globalData.Create(front.globalData, 1 * sizeof(GlobalUBO), BufferType::UBO);
 
-        m_Buffers.entityData.Create(m_GPUDatas.entityData,
-            MAX_ENTITIES * sizeof(EntityMetadata), BufferType::SSBO
-        );
-
-        m_Buffers.drawCommand.Create(m_GPUDatas.drawCommands,
-            MAX_ENTITIES * sizeof(DrawElementsIndirectCommand), BufferType::SSBO
-        );
-
-        m_Buffers.camera.Create(m_GPUDatas.camera, 1 * sizeof(CameraUBO), BufferType::UBO);
-
-        m_Buffers.globalData.Create(m_GPUDatas.globalData, 1 * sizeof(GlobalUBO), BufferType::UBO);
+        m_GPUCulling.Init();
     }
 
     void RenderContext::BindGPUBuffers() const {
-        m_Buffers.drawCommand.Bind(GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 0);
-        m_Buffers.entityData.Bind( GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 1);
-        m_Buffers.transform.Bind(  GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 2);
+        const auto& arena = m_Buffers.arena;
+        const auto& b = m_Buffers;
+
+        // All the SSBOs in one call, binding 3 is free (camera is a UBO)
+        const GLuint handle = arena.GetHandle();
+        const std::array<GLuint, 7> buffers = {
+            handle, handle, handle, 0, handle, b.texture.GetHandle(), handle
+        };
+        const std::array<GLintptr, 7> offsets = {
+            arena.GetOffset(b.drawCommand), arena.GetOffset(b.entityData), arena.GetOffset(b.transform), 0,
+            arena.GetOffset(b.material), 0, arena.GetOffset(b.light)
+        };
+        const std::array<GLsizeiptr, 7> sizes = {
+            arena.GetSize(b.drawCommand), arena.GetSize(b.entityData), arena.GetSize(b.transform), 0,
+            arena.GetSize(b.material), b.texture.GetRegionSize(), arena.GetSize(b.light)
+        };
+        glBindBuffersRange(GL_SHADER_STORAGE_BUFFER, 0, 7, buffers.data(), offsets.data(), sizes.data());
+
+        // Light grid after the culling bindings (9-14)
+        const std::array<GLuint, 2> gridBuffers = { handle, handle };
+        const std::array<GLintptr, 2> gridOffsets = { arena.GetOffset(b.lightCluster), arena.GetOffset(b.lightIndex) };
+        const std::array<GLsizeiptr, 2> gridSizes = { arena.GetSize(b.lightCluster), arena.GetSize(b.lightIndex) };
+        glBindBuffersRange(GL_SHADER_STORAGE_BUFFER, 15, 2, gridBuffers.data(), gridOffsets.data(), gridSizes.data());
+
         m_Buffers.camera.Bind(     GL_UNIFORM_BUFFER,        BufferType::UBO,  3);
-        m_Buffers.material.Bind(   GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 4);
-        m_Buffers.texture.Bind(    GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 5);
-        m_Buffers.light.Bind(      GL_SHADER_STORAGE_BUFFER, BufferType::SSBO, 6);
         m_Buffers.globalData.Bind( GL_UNIFORM_BUFFER,        BufferType::UBO,  7);
     }
 
     void RenderContext::UploadToGPU() {
-        // Update per EntityMetadata
-        m_Buffers.entityData.UploadToGPU(m_GPUDatas.entityData,
-            m_GPUDatas.entityData.size() * sizeof(EntityMetadata), BufferType::SSBO
-        );
+        auto& front = GetGPURenderData();
+        auto& arena = m_Buffers.arena;
+
+        // Next arena region, waits only if the GPU is still behind by GPU_FRAMES_IN_FLIGHT frames
+        arena.BeginFrame();
+
+        // Every region needs its own copy, so dirty data is uploaded once per region
+        if (front.commandsDirty > 0) {
+            // Update per EntityMetadata
+            arena.Upload(m_Buffers.entityData, front.entityData);
+            // Update Draw commands
+            arena.Upload(m_Buffers.drawCommand, front.drawCommands);
+            front.commandsDirty--;
+        }
 
-        // Update Draw commands
-        m_Buffers.drawCommand.UploadToGPU(m_GPUDatas.drawCommands,
-            m_GPUDatas.drawCommands.size() * sizeof(DrawElementsIndirectCommand), BufferType::SSBO
-        );
+        if (front.materialsDirty > 0) {
+            // Update Materials
+            arena.Upload(m_Buffers.material, front.materials);
+            front.materialsDirty--;
+        }
 
-        // Update Transforms
-        m_Buffers.transform.UploadToGPU(m_GPUDatas.transforms,
-            m_GPUDatas.transforms.size() * sizeof(TransformSSBO), BufferType::SSBO
-        );
+        // Culling stats for the editor, the renderer owns the instance counts when the GPU culls
+        auto* editorState = Services::GetEditorState();
+        if (!(editorState->FrustumCulling && editorState->GPUCulling)) {
+            editorState->VisibleInstances  = front.visibleCount;
+            editorState->CulledInstances   = front.culledCount;
+            editorState->OccludedInstances = front.occludedCount;
+        }
+        editorState->VisibleMeshlets  = front.visibleMeshlets;
+        editorState->CulledMeshlets   = front.culledMeshlets;
 
-        // Update Materials
-        m_Buffers.material.UploadToGPU(m_GPUDatas.materials,
-            m_GPUDatas.materials.size() * sizeof(MaterialSSBO), BufferType::SSBO
-        );
+        // Update only the changed transforms
+        UploadTransforms(front.transforms);
+        m_FrontUploaded = true;
 
         // Update Lights
-        m_Buffers.light.UploadToGPU(m_GPUDatas.lights,
-            m_GPUDatas.lights.size() * sizeof(LightSSBO), BufferType::SSBO
-        );
+        arena.Upload(m_Buffers.light, front.lights);
+        arena.Upload(m_Buffers.lightCluster, front.lightClusters);
+        arena.Upload(m_Buffers.lightIndex, front.lightIndices);
+
+        // Whole frame goes with one flush
+        arena.Flush();
 
         // Update Camera
-        m_Buffers.camera.UploadToGPU(std::vector{m_GPUDatas.camera}, 1 * sizeof(CameraUBO), BufferType::UBO);
+        m_Buffers.camera.UploadToGPU(std::vector{front.camera}, 1 * sizeof(CameraUBO), BufferType::UBO);
 
         // Update Global Data
-        m_Buffers.globalData.UploadToGPU(std::vector{m_GPUDatas.globalData}, 1 * sizeof(GlobalUBO), BufferType::UBO);
+        m_Buffers.globalData.UploadToGPU(std::vector{front.globalData}, 1 * sizeof(GlobalUBO), BufferType::UBO);
+    }
+
+    void RenderContext::EndFrame() {
+        // Region written this frame is free again once the GPU passes this fence
+        m_Buffers.arena.EndFrame();
+    }
+
+    void RenderContext::QueueTransforms(const std::vector<TransformDelta> &frameDeltas) {
+        // Slots are persistent, so every region has to see every delta once it becomes the current one
+        for (auto& pending : m_PendingTransforms) {
+            pending.insert(pending.end(), frameDeltas.begin(), frameDeltas.end());
+        }
+    }
+
+    void RenderContext::UploadTransforms(const std::vector<TransformDelta> &frameDeltas) {
+        QueueTransforms(frameDeltas);
+
+        const uint32_t region = m_Buffers.arena.GetRegion();
+        auto& transforms = m_PendingTransforms[region];
+        if (transforms.empty()) return;
+
+        // Same slot may be pending from several frames, the latest one wins
+        std::ranges::stable_sort(transforms, {}, &TransformDelta::slot);
+        const auto last = std::unique(transforms.rbegin(), transforms.rend(),
+            [](const TransformDelta& a, const TransformDelta& b) { return a.slot == b.slot; });
+        transforms.erase(transforms.begin(), last.base());
+
+        // Flushed together with the rest of the frame
+        for (const auto& delta : transforms) {
+            m_Buffers.arena.Write(m_Buffers.transform, &delta.data, delta.slot * sizeof(TransformSSBO), sizeof(TransformSSBO));
+        }
+        transforms.clear();
     }
 
     void RenderContext::CollectRenderables() {
+        // Pipelined rendering was turned off, its last snapshot was extracted but never uploaded
+        // Extraction is about to clean that snapshot, so its transform deltas go before this frame's ones
+        if (!m_FrontUploaded) {
+            QueueTransforms(GetGPURenderData().transforms);
+        }
+
+        ExtractFrame();
+        SwapFrames();
+        UploadToGPU();
+    }
+
+    void RenderContext::SwapFrames() {
+        m_FrontIndex ^= 1;
+        m_FrontUploaded = false;
+    }
+
+    void RenderContext::SetBindlessTextures(const std::vector<GLuint64> &textures) {
+        // Both snapshots share the same texture table
+        for (auto& frame : m_Frames) {
+            frame.textures = textures;
+        }
+    }
+
+    void RenderContext::ExtractFrame() {
         CleanPrevFrame();
+        auto& back = Back();
+
+        // Removed meshes invalidate the cached batches
+        if (const auto& mm = Services::GetMeshManager(); mm && mm->GetVersion() != m_MeshVersion) {
+            m_MeshVersion = mm->GetVersion();
+            m_StructureDirty = true;
+        }
 
-        const auto view = m_Scene->GetAllEntitiesWith<TransformComponent, IDComponent>();
-        uint baseInstance = 0;
+        if (m_StructureDirty) {
+            RebuildDrawCommands();
+        }
 
-        for (auto [entity, transform, id] : view.each()) {
-            const auto e = m_Scene->GetEntityWithUUID(id.m_UUID);
-            if (!e) continue;
+        // Static scene costs just a flag check per entity
+        const auto view = m_Scene->GetAllEntitiesWith<TransformComponent>();
+        for (auto [entity, transform] : view.each()) {
+            if (transform.m_GPUSlot != INVALID_GPU_SLOT && transform.m_Transform.IsGPUDirty())
+                PushTransform(transform);
+        }
 
-            const int transformIndex = PushTransform(transform);
-            CollectCamera(e);
-            CollectLight(e);
+        CollectCamera();
+        CollectLights();
+        m_LightGrid.Build(back.camera, back.lights, back.lightClusters, back.lightIndices);
 
-            for (const auto& [meshData, matUUID] : CollectRenderables(e)) {
-                const int materialIndex = matUUID != 0 ? PushMaterial(matUUID) : 0;
-                PushDrawCommand(meshData, transformIndex, materialIndex, baseInstance);
-                ++baseInstance;
-            }
+        if (back.materialsVersion != m_CommandsVersion) {
+            back.materials        = m_Materials;
+            back.materialsVersion = m_CommandsVersion;
+            back.materialsDirty   = GPU_FRAMES_IN_FLIGHT;
+        }
+
+        // GPU culling consumes the unculled commands, same as the culling being off for the CPU
+        const auto* editorState = Services::GetEditorState();
+        if (editorState->FrustumCulling && !editorState->GPUCulling) {
+            // Visibility changes with the camera, so the culled list is rebuilt every frame
+            CullDrawCommands(back);
+            back.commandsVersion = 0;
+            back.commandsDirty   = GPU_FRAMES_IN_FLIGHT;
+        }
+        else if (back.commandsVersion != m_CommandsVersion) {
+            // Snapshot is behind the last rebuild, bring the commands
+            back.drawCommands    = m_DrawCommands;
+            back.entityData      = m_EntityData;
+            back.commandsVersion = m_CommandsVersion;
+            back.commandsDirty   = GPU_FRAMES_IN_FLIGHT;
+            back.visibleCount    = static_cast<uint32_t>(m_EntityData.size());
+            back.culledCount     = 0;
+            back.occludedCount   = 0;
         }
 
         // Collect others
         CollectGlobalData();
+    }
 
-        UploadToGPU();
+    void RenderContext::RebuildDrawCommands() {
+        const auto start = std::chrono::steady_clock::now();
+        const auto& mm = Services::GetMeshManager();
+
+        m_DrawCommands.clear();
+        m_EntityData.clear();
+        m_Materials.clear();
+        m_OccluderPositions.clear(); // Mesh handles may point to other meshes now
+        m_MaterialIdxCache.assign(m_MaterialIdxCache.size(), -1);
+
+        // New entities get their slot and their first upload here
+        const auto transforms = m_Scene->GetAllEntitiesWith<TransformComponent>();
+        for (auto [entity, transform] : transforms.each()) {
+            if (transform.m_GPUSlot != INVALID_GPU_SLOT) continue;
+            transform.m_GPUSlot = AllocateTransformSlot();
+            if (transform.m_GPUSlot != INVALID_GPU_SLOT)
+                PushTransform(transform);
+        }
+
+        // Group the renderables by (mesh, material), every group becomes one instanced draw
+        auto& batches = m_Batches;
+        batches.clear();
+        std::unordered_map<uint64_t, size_t> batchLookup;
+
+        const auto view = m_Scene->GetAllEntitiesWith<TransformComponent, MeshRendererComponent>();
+        for (auto [entity, transform, mrc] : view.each()) {
+            if (transform.m_GPUSlot == INVALID_GPU_SLOT) continue;
+
+            for (const auto& [mesh, material] : CollectRenderables(mrc)) {
+                const auto* meshData = mm->GetMeshData(mesh);
+                if (!meshData) continue;
+                const int materialIndex = material.IsValid() ? PushMaterial(material) : 0;
+
+                const uint64_t key = static_cast<uint64_t>(mesh.m_Index) << 32 | static_cast<uint32_t>(materialIndex);
+                const auto [it, inserted] = batchLookup.try_emplace(key, batches.size());
+                if (inserted) {
+                    batches.push_back({ *meshData, static_cast<int>(mesh.m_Index), mm->GetMeshlets(mesh), materialIndex, {} });
+                }
+                batches[it->second].transformIndices.push_back(static_cast<int>(transform.m_GPUSlot));
+            }
+        }
+
+        for (const auto& batch : batches) {
+            PushDrawCommand(batch, batch.transformIndices, m_DrawCommands, m_EntityData);
+        }
+
+        m_StructureDirty = false;
+        m_CommandsVersion++;
+
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[RenderContext] Rebuilt {} draw commands ({} instances) in {:.3f} ms",
+            m_DrawCommands.size(), m_EntityData.size(), elapsed));
     }
 
-    void RenderContext::CollectCamera(const Entity* entity) {
+    void RenderContext::CollectCamera() {
         /*
          * TODO: An update is required to add multiple cameras during run-time
          * (currently, adding multiple cameras may cause to crash)!!
          */
-        // const auto cam = Services::GetEditorState()->camera; // TODO: if it doesn't work REMEMBER THIS SHIT!
-        if (entity->HasComponent<CameraComponent>()) {
-            auto& cc = entity->GetComponentUnchecked<CameraComponent>();
-            auto& tc = entity->GetComponentUnchecked<TransformComponent>();
-            m_GPUDatas.camera = cc.m_Camera.ConvertToGPUFormat(tc.m_Transform);
+        const auto view = m_Scene->GetAllEntitiesWith<CameraComponent, TransformComponent>();
+        for (auto [entity, cc, tc] : view.each()) {
+            Back().camera = cc.m_Camera.ConvertToGPUFormat(tc.m_Transform);
         }
     }
 
-    int RenderContext::PushTransform(TransformComponent& tc) {
-        const TransformSSBO gpuTransform = tc.m_Transform.ConvertToGPUFormat();
-        const int index = static_cast<int>(m_GPUDatas.transforms.size());
-        m_GPUDatas.transforms.push_back(gpuTransform);
-        return index;
+    void RenderContext::PushTransform(TransformComponent& tc) {
+        const auto data = tc.m_Transform.ConvertToGPUFormat();
+        Back().transforms.push_back({ tc.m_GPUSlot, data });
+        // CPU copy for the culling
+        m_SlotMatrices[tc.m_GPUSlot] = data.modelMatrix;
+        tc.m_Transform.ClearGPUDirty();
+    }
+
+    void RenderContext::CullDrawCommands(GPUData &frame) {
+        frame.drawCommands.clear();
+        frame.entityData.clear();
+        frame.visibleCount  = 0;
+        frame.culledCount   = 0;
+        frame.occludedCount = 0;
+        frame.visibleMeshlets = 0;
+        frame.culledMeshlets  = 0;
+
+        const math::Frustum frustum(frame.camera.viewProjection);
+        const glm::vec3 cameraPos = frame.camera.position;
+        std::vector<int> visible;
+
+        const bool occlusion = m_Scene->GetRenderSettings().m_OcclusionCulling;
+        if (occlusion) RasterizeOccluders(frame, frustum);
+
+        for (const auto& batch : m_Batches) {
+            const glm::vec3 localCenter = batch.mesh.m_Bounds.GetCenter();
+            const float localRadius = batch.mesh.m_Bounds.GetRadius();
+
+            visible.clear();
+            uint32_t occluded = 0;
+            for (const int transformIndex : batch.transformIndices) {
+                const auto& model = m_SlotMatrices[transformIndex];
+                const glm::vec3 center = model * glm::vec4(localCenter, 1.0f);
+                // Non uniform scale, take the biggest axis so the sphere still covers the mesh
+                const float scale = glm::max(glm::length(glm::vec3(model[0])),
+                    glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+                if (!frustum.IntersectsSphere(center, localRadius * scale)) continue;
+                if (occlusion && !m_OcclusionBuffer.IsVisible(batch.mesh.m_Bounds, model)) {
+                    occluded++;
+                    continue;
+                }
+                visible.push_back(transformIndex);
+            }
+
+            frame.visibleCount  += static_cast<uint32_t>(visible.size());
+            frame.occludedCount += occluded;
+            frame.culledCount   += static_cast<uint32_t>(batch.transformIndices.size() - visible.size()) - occluded;
+
+            if (batch.meshlets.empty()) {
+                if (!visible.empty())
+                    PushDrawCommand(batch, visible, frame.drawCommands, frame.entityData);
+                continue;
+            }
+
+            // Dense meshes, only the visible parts of every visible instance are drawn
+            for (const int transformIndex : visible)
+                PushMeshletCommands(batch, transformIndex, frustum, cameraPos, frame);
+        }
     }
 
-    int RenderContext::PushMaterial(const UUID& materialUUID) {
-        const auto it = m_MaterialIdxCache.find(materialUUID);
-        if (it != m_MaterialIdxCache.end())
-            return it->second;
+    void RenderContext::RasterizeOccluders(const GPUData& frame, const math::Frustum& frustum) {
+        struct Occluder {
+            const DrawBatch* batch;
+            int transformIndex;
+            float size; // Bounding radius / distance
+        };
+        std::vector<Occluder> occluders;
+        const glm::vec3 cameraPos = frame.camera.position;
+
+        for (const auto& batch : m_Batches) {
+            // Dense meshes would cost more to rasterize than they save
+            if (batch.mesh.m_IndexCount / 3 > OCCLUSION_MAX_OCCLUDER_TRIANGLES) continue;
+            const glm::vec3 localCenter = batch.mesh.m_Bounds.GetCenter();
+            const float localRadius = batch.mesh.m_Bounds.GetRadius();
+
+            for (const int transformIndex : batch.transformIndices) {
+                const auto& model = m_SlotMatrices[transformIndex];
+                const glm::vec3 center = model * glm::vec4(localCenter, 1.0f);
+                const float radius = localRadius * glm::max(glm::length(glm::vec3(model[0])),
+                    glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+                if (!frustum.IntersectsSphere(center, radius)) continue;
+
+                const float size = radius / glm::max(glm::length(center - cameraPos), 0.001f);
+                if (size >= OCCLUSION_MIN_OCCLUDER_SIZE)
+                    occluders.push_back({ &batch, transformIndex, size });
+            }
+        }
 
-        const auto& am = Services::GetAssetManager();
-        const auto mat = am->GetMaterialInstance(materialUUID);
+        // Biggest ones first, the slot breaks the ties so the selection doesn't depend on the sort
+        const auto count = std::min<size_t>(occluders.size(), OCCLUSION_MAX_OCCLUDERS);
+        std::partial_sort(occluders.begin(), occluders.begin() + static_cast<std::ptrdiff_t>(count), occluders.end(),
+            [](const Occluder& a, const Occluder& b) {
+                return a.size != b.size ? a.size > b.size : a.transformIndex < b.transformIndex;
+            });
+
+        const auto& mm = Services::GetMeshManager();
+        m_OcclusionBuffer.Begin(frame.camera.viewProjection);
+        for (size_t i = 0; i < count; i++) {
+            const auto& batch = *occluders[i].batch;
+            m_OcclusionBuffer.AddOccluder(GetOccluderPositions(batch), mm->ViewIndices(batch.mesh.m_MeshUUID),
+                m_SlotMatrices[occluders[i].transformIndex]);
+        }
 
-        const int index = m_GPUDatas.materials.size();
-        m_GPUDatas.materials.push_back(mat->ConvertToGPUFormat());
-        m_MaterialIdxCache[materialUUID] = index;
+        // Tiles on the workers, serial without a job system
+        auto* taskManager = Services::GetTaskManager();
+        if (!taskManager) {
+            m_OcclusionBuffer.Rasterize();
+            return;
+        }
+        m_OcclusionBuffer.Rasterize([taskManager](size_t tileCount, const std::function<void(size_t, size_t)>& func) {
+            taskManager->ParallelFor(tileCount, func);
+        });
+    }
 
-        return index;
+    const std::vector<glm::vec3>& RenderContext::GetOccluderPositions(const DrawBatch& batch) {
+        auto [it, inserted] = m_OccluderPositions.try_emplace(batch.meshIndex);
+        if (!inserted) return it->second;
+
+        const auto vertices = Services::GetMeshManager()->ViewVertices(batch.mesh.m_MeshUUID);
+        it->second.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            it->second.push_back(math::UnpackVertex(vertex, batch.mesh.m_Bounds).m_Position);
+        }
+        return it->second;
     }
 
-    void RenderContext::PushDrawCommand(const MeshAsset* mesh, int transformIndex, int materialIndex,uint baseInstance)
+    void RenderContext::PushMeshletCommands(const DrawBatch& batch, int transformIndex, const math::Frustum& frustum,
+        const glm::vec3& cameraPos, GPUData& frame)
     {
-        if (mesh) {
+        const auto& model = m_SlotMatrices[transformIndex];
+        const glm::vec3 axisScale(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])));
+        const float maxScale = glm::max(axisScale.x, glm::max(axisScale.y, axisScale.z));
+        const float minScale = glm::min(axisScale.x, glm::min(axisScale.y, axisScale.z));
+        // Non uniform scale bends the normal cone, only the sphere test is safe then
+        const bool testCone = minScale > 0.0f && maxScale / minScale < 1.01f;
+        const glm::mat3 rotation = testCone ? glm::mat3(model) / maxScale : glm::mat3(1.0f);
+
+        const auto baseInstance = static_cast<uint>(frame.entityData.size());
+        const size_t firstCommand = frame.drawCommands.size();
+        uint32_t runStart = 0, runCount = 0;
+
+        const auto FlushRun = [&] {
+            if (runCount == 0) return;
             DrawElementsIndirectCommand cmd{};
-            cmd.count         = mesh->m_IndexCount;
+            cmd.count         = runCount;
             cmd.instanceCount = 1;
-            cmd.firstIndex    = mesh->m_IndexOffset;
-            cmd.baseVertex    = 0;
+            cmd.firstIndex    = static_cast<uint>(batch.mesh.m_IndexOffset) + runStart;
+            cmd.baseVertex    = batch.mesh.m_VertexOffset;
             cmd.baseInstance  = baseInstance;
+            frame.drawCommands.push_back(cmd);
+            runCount = 0;
+        };
+
+        for (const auto& meshlet : batch.meshlets) {
+            const glm::vec3 center = model * glm::vec4(meshlet.m_Center, 1.0f);
+            const float radius = meshlet.m_Radius * maxScale;
+
+            bool visible = frustum.IntersectsSphere(center, radius);
+            if (visible && testCone && meshlet.m_ConeCutoff < 1.0f) {
+                // Every face of the meshlet looks away from the camera
+                const glm::vec3 toCenter = center - cameraPos;
+                const glm::vec3 axis = rotation * meshlet.m_ConeAxis;
+                visible = glm::dot(toCenter, axis) < meshlet.m_ConeCutoff * glm::length(toCenter) + radius;
+            }
 
-            m_GPUDatas.drawCommands.push_back(cmd);
+            if (!visible) {
+                FlushRun();
+                frame.culledMeshlets++;
+                continue;
+            }
+            frame.visibleMeshlets++;
+
+            // Meshlets are contiguous in the index buffer, neighbours merge into one command
+            if (runCount == 0) runStart = meshlet.m_IndexOffset;
+            runCount += meshlet.m_IndexCount;
         }
+        FlushRun();
 
+        if (frame.drawCommands.size() > firstCommand)
+            frame.entityData.push_back(MakeEntityMetadata(batch, transformIndex));
+    }
+
+    EntityMetadata RenderContext::MakeEntityMetadata(const DrawBatch &batch, int transformIndex) {
         EntityMetadata em{};
         em.transformIndex = transformIndex;
-        em.materialIndex  = materialIndex;
-        if (mesh) {
-            em.indexCount  = static_cast<int>(mesh->m_IndexCount);
-            em.indexOffset = static_cast<int>(mesh->m_IndexOffset);
-        }
+        em.materialIndex  = batch.materialIndex;
+        em.indexCount     = static_cast<int>(batch.mesh.m_IndexCount);
+        em.indexOffset    = static_cast<int>(batch.mesh.m_IndexOffset);
+        em.meshIndex      = batch.meshIndex;
+        return em;
+    }
+
+    int RenderContext::PushMaterial(const MaterialHandle& material) {
+        if (material.m_Index >= m_MaterialIdxCache.size())
+            m_MaterialIdxCache.resize(material.m_Index + 1, -1);
+
+        auto& cached = m_MaterialIdxCache[material.m_Index];
+        if (cached >= 0)
+            return cached;
+
+        const auto mat = Services::GetAssetManager()->GetMaterialInstance(material);
+        if (!mat) return 0;
+
+        cached = static_cast<int>(m_Materials.size());
+        m_Materials.push_back(mat->ConvertToGPUFormat());
 
-        m_GPUDatas.entityData.push_back(em);
+        return cached;
     }
 
-    std::vector<RenderableData> RenderContext::CollectRenderables(const Entity* entity) {
-        std::vector<RenderableData> result;
+    void RenderContext::PushDrawCommand(const DrawBatch& batch, std::span<const int> transformIndices,
+        std::vector<DrawElementsIndirectCommand>& commands, std::vector<EntityMetadata>& entityData)
+    {
+        // Instances of the batch are contiguous in entityData, shader reads them with gl_BaseInstance + gl_InstanceID
+        DrawElementsIndirectCommand cmd{};
+        cmd.count         = batch.mesh.m_IndexCount;
+        cmd.instanceCount = static_cast<uint>(transformIndices.size());
+        cmd.firstIndex    = batch.mesh.m_IndexOffset;
+        cmd.baseVertex    = batch.mesh.m_VertexOffset; // Pool indices are local to the mesh
+        cmd.baseInstance  = static_cast<uint>(entityData.size());
+
+        commands.push_back(cmd);
+
+        for (const int transformIndex : transformIndices) {
+            entityData.push_back(MakeEntityMetadata(batch, transformIndex));
+        }
+    }
 
-        if (entity->HasComponent<MeshRendererComponent>()) {
-            const auto& mrc = entity->GetComponentUnchecked<MeshRendererComponent>();
+    std::vector<RenderableData> RenderContext::CollectRenderables(MeshRendererComponent& mrc) {
+        std::vector<RenderableData> result;
 
-            // Using same count for meshes and materials since each mesh has one material
-            if (mrc.m_MeshUUIDs.size() != mrc.m_MaterialInstanceUUIDs.size()) {
-                Warn("[RenderContext::CollectMeshes] MeshUUID count does not match MaterialInstanceUUIDs, Fix it!!");
-                return result;
-            }
-            const size_t size = mrc.m_MeshUUIDs.size();
+        // Using same count for meshes and materials since each mesh has one material
+        if (mrc.m_MeshUUIDs.size() != mrc.m_MaterialInstanceUUIDs.size()) {
+            Warn("[RenderContext::CollectMeshes] MeshUUID count does not match MaterialInstanceUUIDs, Fix it!!");
+            return result;
+        }
+        const size_t size = mrc.m_MeshUUIDs.size();
+
+        // Handles are plain indices, UUIDs are resolved again only when meshes were added or removed
+        // (a removed and recreated mesh gets another generation, a missing one may be loaded now)
+        const auto& mm = Services::GetMeshManager();
+        if (mrc.m_MeshHandles.size() != size || mrc.m_HandleVersion != mm->GetVersion()) {
+            const auto& am = Services::GetAssetManager();
+            mrc.m_HandleVersion = mm->GetVersion();
+            mrc.m_MeshHandles.clear();
+            mrc.m_MaterialHandles.clear();
             for (size_t i = 0; i < size; i++) {
-                RenderableData data;
-                data.m_Mesh = Services::GetMeshManager()->GetMeshData(mrc.m_MeshUUIDs[i]);
-                data.m_MaterialUUID = mrc.m_MaterialInstanceUUIDs[i];
-                result.push_back(data);
+                mrc.m_MeshHandles.push_back(mm->GetMeshHandle(mrc.m_MeshUUIDs[i]));
+                mrc.m_MaterialHandles.push_back(am->GetMaterialInstanceHandle(mrc.m_MaterialInstanceUUIDs[i]));
             }
         }
 
+        result.reserve(size);
+        for (size_t i = 0; i < size; i++) {
+            result.push_back({ mrc.m_MeshHandles[i], mrc.m_MaterialHandles[i] });
+        }
+
         return result;
     }
 
-    void RenderContext::CollectLight(const Entity* entity) {
-        if (entity->HasComponent<LightComponent>()) {
-            auto& lc = entity->GetComponentUnchecked<LightComponent>();
-            auto& tc = entity->GetComponentUnchecked<TransformComponent>();
-            m_GPUDatas.lights.push_back(lc.m_Light.ConvertToGPUFormat(tc.m_Transform));
+    void RenderContext::CollectLights() {
+        const auto view = m_Scene->GetAllEntitiesWith<LightComponent, TransformComponent>();
+        for (auto [entity, lc, tc] : view.each()) {
+            Back().lights.push_back(lc.m_Light.ConvertToGPUFormat(tc.m_Transform));
         }
     }
 
     void RenderContext::CollectGlobalData() {
-        m_GPUDatas.globalData.GlobalAmbient = glm::vec4(0.1);
-        m_GPUDatas.globalData.lightCount[0] = 1; // TODO: remove the hardcoded value for multiple lighting!!!
+        auto& back = Back();
+        back.globalData.GlobalAmbient = glm::vec4(0.1);
+        back.globalData.lightCount[0] = static_cast<int>(back.lights.size());
+        back.globalData.clusterGrid   = glm::uvec4(LIGHT_CLUSTER_X, LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, 0);
+        const float zNear = m_LightGrid.GetNear(), zFar = m_LightGrid.GetFar();
+        back.globalData.clusterDepth  = glm::vec4(zNear, zFar, std::log(zFar / zNear), 0.0f);
     }
 
     void RenderContext::CleanPrevFrame() {
-        // TODO: need dirty tracking system to avoid unnecessary uploads
-        m_GPUDatas.drawCommands.clear();
-        m_GPUDatas.entityData.clear();
-        m_GPUDatas.lights.clear();
-        m_GPUDatas.transforms.clear();
-        // TODO: add material dirty tracker or you can't update the buffer with 'additional data'?
+        // Deltas of this snapshot are already uploaded when it was the front one
+        auto& back = Back();
+        back.transforms.clear();
+        back.lights.clear();
+    }
+
+    uint32_t RenderContext::AllocateTransformSlot() {
+        if (!m_FreeTransformSlots.empty()) {
+            const auto slot = m_FreeTransformSlots.back();
+            m_FreeTransformSlots.pop_back();
+            return slot;
+        }
+        if (m_NextTransformSlot >= MAX_ENTITIES) {
+            Warn("[RenderContext] Out of transform slots! MAX_ENTITIES reached");
+            return INVALID_GPU_SLOT;
+        }
+        m_SlotMatrices.emplace_back(1.0f);
+        return m_NextTransformSlot++;
+    }
+
+    void RenderContext::OnStructureChanged(entt::registry &registry, entt::entity entity) {
+        m_StructureDirty = true;
+    }
+
+    void RenderContext::OnTransformDestroyed(entt::registry &registry, entt::entity entity) {
+        auto& transform = registry.get<TransformComponent>(entity);
+        if (transform.m_GPUSlot != INVALID_GPU_SLOT) {
+            m_FreeTransformSlots.push_back(transform.m_GPUSlot);
+            transform.m_GPUSlot = INVALID_GPU_SLOT;
+        }
+        m_StructureDirty = true;
     }
 }
@@ -8,6 +8,7 @@
 #include "Core/AssetManager.h"
 #include "Core/Services.h"
 #include "Core/Timer.h"
+#include "Editor/EditorState.h"
 #include "Graphics/MeshManager.h"
 #include "Graphics/Transformations.h"
 #include "Scene/Components.h"
@@ -37,12 +38,54 @@ namespace Real::opengl {
 
         // Draw indirect
         const auto& gpuData = m_SceneRenderContext->GetGPURenderData();
-        if (!gpuData.drawCommands.empty()) {
-            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, GetRenderContext()->GetBuffers().drawCommand.GetHandle());
-            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(gpuData.drawCommands.size()), 0);
+        auto* editorState = Services::GetEditorState();
+        if (editorState->FrustumCulling && editorState->GPUCulling) {
+            // Commands and entity data are the unculled ones, the compute pass filters them
+            auto& culling = m_SceneRenderContext->GetGPUCulling();
+            const auto commandCount  = static_cast<uint32_t>(gpuData.drawCommands.size());
+            const auto instanceCount = static_cast<uint32_t>(gpuData.entityData.size());
+            const uint32_t region = GetRenderContext()->GetBuffers().arena.GetRegion();
+
+            // Counters of the last frame which used this region, its fence is passed already
+            const auto stats = culling.ReadStats(region);
+            editorState->VisibleInstances  = stats.visible;
+            editorState->CulledInstances   = stats.frustumCulled;
+            editorState->OccludedInstances = stats.occluded;
+
+            if (m_Scene->GetRenderSettings().m_OcclusionCulling) {
+                culling.SyncVisibility(gpuData.commandsVersion);
+                culling.Dispatch(commandCount, instanceCount, CullPhase::EARLY);
+                shader.Bind();
+                culling.BindForDraw();
+                culling.Draw(commandCount);
+
+                culling.BuildDepthPyramid();
+
+                // Entity data binding was taken by the culled list
+                BindGPUBuffers();
+                culling.Dispatch(commandCount, instanceCount, CullPhase::LATE);
+                shader.Bind();
+                culling.BindForDraw();
+                culling.Draw(commandCount);
+            }
+            else {
+                culling.Dispatch(commandCount, instanceCount);
+                shader.Bind();
+                culling.BindForDraw();
+                culling.Draw(commandCount);
+            }
+            culling.CopyStats(region);
+        }
+        else if (!gpuData.drawCommands.empty()) {
+            const auto& buffers = GetRenderContext()->GetBuffers();
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers.arena.GetHandle());
+            // Commands of this frame are in the current arena region
+            const auto offset = reinterpret_cast<const void*>(buffers.arena.GetOffset(buffers.drawCommand));
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, static_cast<GLsizei>(gpuData.drawCommands.size()), 0);
         }
 
         meshManager->UnbindCurrVAO();
+        m_SceneRenderContext->EndFrame();
     }
 
     void Renderer::BindGPUBuffers() const {
@@ -31,6 +31,23 @@ namespace Real {
         CheckCompileErrors(m_Program, "PROGRAM");
     }
 
+    Shader::Shader(std::string computePath, std::string name)
+        : m_ComputePath(std::move(computePath)), m_Name(std::move(name))
+    {
+        const char* cSource = m_ComputePath.c_str();
+
+        const auto compute = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(compute, 1, &cSource, nullptr);
+        glCompileShader(compute);
+        CheckCompileErrors(compute, "COMPUTE");
+
+        m_Program = glCreateProgram();
+        glAttachShader(m_Program, compute);
+        glLinkProgram(m_Program);
+        CheckCompileErrors(m_Program, "PROGRAM");
+        glDeleteShader(compute);
+    }
+
     void Shader::SetInt(const std::string &name, int value) const {
         glUniform1i(GetULocation(name), (int)value);
     }
@@ -40,7 +57,7 @@ namespace Real {
     }
 
     void Shader::SetUint(const std::string &name, uint value) const {
-        glUniform1f(GetULocation(name), (uint)value);
+        glUniform1ui(GetULocation(name), value);
     }
 
     void Shader::SetFloat(const std::string &name, float value) const {
@@ -242,6 +242,7 @@ namespace Real {
 
         switch (m_ImageFormatState) {
             case ImageFormatState::COMPRESS_ME:
+                // Should be rare, the importer compresses everything in batches before the upload
                 tools::CompressTextureAndReadFromFile(this);
                 // Don't break the switch statement and load compressed state!
 
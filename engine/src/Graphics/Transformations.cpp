@@ -14,6 +14,7 @@ namespace Real {
         m_ModelMatrix        = translate * rotate * scale;
 
         m_ModelMatrixDirty = false;
+        m_GPUDirty = true;
     }
 
     TransformSSBO Transformations::ConvertToGPUFormat() {
@@ -0,0 +1,71 @@
+//
+// Created by pointerlost on 1/9/26.
+//
+#include "Math/Frustum.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define REAL_FRUSTUM_SSE 1
+#endif
+
+namespace Real::math {
+
+    Frustum::Frustum(const glm::mat4 &viewProjection) {
+        // glm is column major, m[col][row]
+        const auto row = [&viewProjection](int r) {
+            return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+        };
+        const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        const glm::vec4 planes[6] = {
+            r3 + r0, // Left
+            r3 - r0, // Right
+            r3 + r1, // Bottom
+            r3 - r1, // Top
+            r3 + r2, // Near (OpenGL clip space, -w <= z)
+            r3 - r2, // Far
+        };
+
+        for (int i = 0; i < 6; i++) {
+            // Normalized so the distance can be compared with the radius
+            const float invLength = 1.0f / glm::length(glm::vec3(planes[i]));
+            m_PlaneX[i] = planes[i].x * invLength;
+            m_PlaneY[i] = planes[i].y * invLength;
+            m_PlaneZ[i] = planes[i].z * invLength;
+            m_PlaneW[i] = planes[i].w * invLength;
+        }
+
+        // Padding planes: distance is always +inf-ish
+        for (int i = 6; i < 8; i++) {
+            m_PlaneX[i] = m_PlaneY[i] = m_PlaneZ[i] = 0.0f;
+            m_PlaneW[i] = 1e30f;
+        }
+    }
+
+    bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const {
+#ifdef REAL_FRUSTUM_SSE
+        const __m128 cx = _mm_set1_ps(center.x);
+        const __m128 cy = _mm_set1_ps(center.y);
+        const __m128 cz = _mm_set1_ps(center.z);
+        const __m128 negRadius = _mm_set1_ps(-radius);
+
+        for (int i = 0; i < 8; i += 4) {
+            // dist = dot(plane.xyz, center) + plane.w
+            __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_load_ps(m_PlaneX + i), cx), _mm_load_ps(m_PlaneW + i));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_load_ps(m_PlaneY + i), cy));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_load_ps(m_PlaneZ + i), cz));
+
+            if (_mm_movemask_ps(_mm_cmplt_ps(dist, negRadius)) != 0)
+                return false;
+        }
+        return true;
+#else
+        for (int i = 0; i < 6; i++) {
+            const float dist = m_PlaneX[i] * center.x + m_PlaneY[i] * center.y + m_PlaneZ[i] * center.z + m_PlaneW[i];
+            if (dist < -radius)
+                return false;
+        }
+        return true;
+#endif
+    }
+}
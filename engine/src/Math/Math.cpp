@@ -2,7 +2,9 @@
 // Created by pointerlost on 10/20/25.
 //
 #include "Math/Math.h"
+#include <cmath>
 #define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtc/packing.hpp"
 #include "glm/gtx/matrix_decompose.hpp"
 
 namespace Real::math {
@@ -83,4 +85,81 @@ namespace Real::math {
         }
         return abs(y - num) > abs(x - num) ? x : y;
     }
+
+    AABB ComputeAABB(std::span<const Vertex> vertices) {
+        if (vertices.empty()) return {};
+
+        AABB bounds{ vertices[0].m_Position, vertices[0].m_Position };
+        for (const auto& v : vertices) {
+            bounds.m_Min = glm::min(bounds.m_Min, v.m_Position);
+            bounds.m_Max = glm::max(bounds.m_Max, v.m_Position);
+        }
+        return bounds;
+    }
+
+    AABB ToAABB(const MeshBinaryHeader &header) {
+        return {
+            glm::vec3(header.m_BoundsMin[0], header.m_BoundsMin[1], header.m_BoundsMin[2]),
+            glm::vec3(header.m_BoundsMax[0], header.m_BoundsMax[1], header.m_BoundsMax[2])
+        };
+    }
+
+    void WriteAABB(const AABB &bounds, MeshBinaryHeader &header) {
+        for (int i = 0; i < 3; i++) {
+            header.m_BoundsMin[i] = bounds.m_Min[i];
+            header.m_BoundsMax[i] = bounds.m_Max[i];
+        }
+    }
+
+    glm::vec2 OctEncode(const glm::vec3 &n) {
+        const glm::vec3 p = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+        if (p.z >= 0.0f) return { p.x, p.y };
+
+        // Fold the lower hemisphere over the diagonals
+        return {
+            (1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f)
+        };
+    }
+
+    glm::vec3 OctDecode(const glm::vec2 &e) {
+        glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        const float t = glm::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    PackedVertex PackVertex(const Vertex &v, const AABB &bounds) {
+        PackedVertex out{};
+        const glm::vec3 extent = bounds.m_Max - bounds.m_Min;
+        for (int i = 0; i < 3; i++) {
+            // Flat axis (e.g. a plane), everything sits on the min
+            const float t = extent[i] > 0.0f ? (v.m_Position[i] - bounds.m_Min[i]) / extent[i] : 0.0f;
+            out.m_Position[i] = static_cast<uint16_t>(std::lround(glm::clamp(t, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        const float len = glm::length(v.m_Normal);
+        const glm::vec3 normal = len > 0.0f ? v.m_Normal / len : glm::vec3(0.0f, 0.0f, 1.0f);
+        out.m_Normal = glm::packSnorm2x16(OctEncode(normal));
+        out.m_UV     = glm::packHalf2x16(v.m_UV);
+        return out;
+    }
+
+    Vertex UnpackVertex(const PackedVertex &v, const AABB &bounds) {
+        Vertex out{};
+        const glm::vec3 q(v.m_Position[0], v.m_Position[1], v.m_Position[2]);
+        out.m_Position = bounds.m_Min + q / 65535.0f * (bounds.m_Max - bounds.m_Min);
+        out.m_Normal   = OctDecode(glm::unpackSnorm2x16(v.m_Normal));
+        out.m_UV       = glm::unpackHalf2x16(v.m_UV);
+        return out;
+    }
+
+    std::vector<PackedVertex> PackVertices(std::span<const Vertex> vertices, const AABB &bounds) {
+        std::vector<PackedVertex> out(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            out[i] = PackVertex(vertices[i], bounds);
+        }
+        return out;
+    }
 }
@@ -0,0 +1,245 @@
+//
+// Created by pointerlost on 1/15/26.
+//
+#include "Math/OcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define REAL_OCCLUSION_SSE 1
+#endif
+
+namespace Real::math {
+
+    // Vertices closer than this (clip w) are treated as crossing the near plane
+    static constexpr float NEAR_W_EPSILON = 1e-5f;
+
+    OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) {
+        m_TilesX = (width  + OCCLUSION_TILE_WIDTH  - 1) / OCCLUSION_TILE_WIDTH;
+        m_TilesY = (height + OCCLUSION_TILE_HEIGHT - 1) / OCCLUSION_TILE_HEIGHT;
+        m_Width  = m_TilesX * OCCLUSION_TILE_WIDTH;
+        m_Height = m_TilesY * OCCLUSION_TILE_HEIGHT;
+        m_Depth.assign(static_cast<size_t>(m_Width) * m_Height, 1.0f);
+        m_TileMaxDepth.assign(static_cast<size_t>(m_TilesX) * m_TilesY, 1.0f);
+        m_TileBins.resize(m_TileMaxDepth.size());
+    }
+
+    bool OcclusionBuffer::HasSIMD() {
+#ifdef REAL_OCCLUSION_SSE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void OcclusionBuffer::Begin(const glm::mat4 &viewProjection) {
+        m_ViewProjection = viewProjection;
+        std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+        std::fill(m_TileMaxDepth.begin(), m_TileMaxDepth.end(), 1.0f);
+        m_Triangles.clear();
+        for (auto& bin : m_TileBins) bin.clear(); // Keeps the capacity for the next frame
+    }
+
+    void OcclusionBuffer::AddOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices,
+        const glm::mat4 &model)
+    {
+        const glm::mat4 mvp = m_ViewProjection * model;
+        const auto width  = static_cast<float>(m_Width);
+        const auto height = static_cast<float>(m_Height);
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            glm::vec3 screen[3];
+            float maxDepth = 0.0f;
+            bool clipped = false;
+
+            for (int v = 0; v < 3; v++) {
+                const uint32_t index = indices[i + v];
+                if (index >= positions.size()) { clipped = true; break; }
+                const glm::vec4 clip = mvp * glm::vec4(positions[index], 1.0f);
+                // No clipping, an occluder losing a triangle only culls less
+                if (clip.w <= NEAR_W_EPSILON || clip.z < -clip.w) { clipped = true; break; }
+
+                const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+                screen[v] = glm::vec3((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height, ndc.z * 0.5f + 0.5f);
+                maxDepth = std::max(maxDepth, screen[v].z);
+            }
+            if (clipped) continue;
+
+            // Both windings, the nearer face wins anyway and imported meshes don't agree on the front face
+            const float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y)
+                             - (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+            if (std::abs(area) < 1e-6f) continue;
+            if (area < 0.0f) std::swap(screen[1], screen[2]);
+
+            ScreenTriangle tri{};
+            tri.m_MinX = std::max(0, static_cast<int>(std::floor(std::min({ screen[0].x, screen[1].x, screen[2].x }))));
+            tri.m_MinY = std::max(0, static_cast<int>(std::floor(std::min({ screen[0].y, screen[1].y, screen[2].y }))));
+            tri.m_MaxX = std::min(static_cast<int>(m_Width) - 1, static_cast<int>(std::floor(std::max({ screen[0].x, screen[1].x, screen[2].x }))));
+            tri.m_MaxY = std::min(static_cast<int>(m_Height) - 1, static_cast<int>(std::floor(std::max({ screen[0].y, screen[1].y, screen[2].y }))));
+            if (tri.m_MinX > tri.m_MaxX || tri.m_MinY > tri.m_MaxY) continue;
+
+            for (int e = 0; e < 3; e++) {
+                // Shared edges are set up from the same end both times and only the sign is flipped,
+                // so the two triangles get exactly opposite values and no pixel center falls between them
+                const glm::vec3* a = &screen[e];
+                const glm::vec3* b = &screen[(e + 1) % 3];
+                const bool flip = a->x > b->x || (a->x == b->x && a->y > b->y);
+                if (flip) std::swap(a, b);
+
+                const float sign = flip ? -1.0f : 1.0f;
+                tri.m_A[e] = sign * (a->y - b->y);
+                tri.m_B[e] = sign * (b->x - a->x);
+                tri.m_C[e] = sign * -((a->y - b->y) * a->x + (b->x - a->x) * a->y);
+            }
+            tri.m_MaxDepth = std::min(maxDepth, 1.0f);
+
+            const auto triIndex = static_cast<uint32_t>(m_Triangles.size());
+            m_Triangles.push_back(tri);
+
+            const uint32_t tileMinX = tri.m_MinX / OCCLUSION_TILE_WIDTH,  tileMaxX = tri.m_MaxX / OCCLUSION_TILE_WIDTH;
+            const uint32_t tileMinY = tri.m_MinY / OCCLUSION_TILE_HEIGHT, tileMaxY = tri.m_MaxY / OCCLUSION_TILE_HEIGHT;
+            for (uint32_t ty = tileMinY; ty <= tileMaxY; ty++) {
+                for (uint32_t tx = tileMinX; tx <= tileMaxX; tx++) {
+                    m_TileBins[ty * m_TilesX + tx].push_back(triIndex);
+                }
+            }
+        }
+    }
+
+    void OcclusionBuffer::Rasterize(const TileRunner &runner) {
+        const auto RasterizeTiles = [this](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; tile++) RasterizeTile(static_cast<uint32_t>(tile));
+        };
+
+        if (runner) runner(m_TileBins.size(), RasterizeTiles);
+        else RasterizeTiles(0, m_TileBins.size());
+    }
+
+    void OcclusionBuffer::RasterizeTile(uint32_t tile) {
+        const auto& bin = m_TileBins[tile];
+        if (bin.empty()) return;
+
+        const int tileX0 = static_cast<int>(tile % m_TilesX) * OCCLUSION_TILE_WIDTH;
+        const int tileY0 = static_cast<int>(tile / m_TilesX) * OCCLUSION_TILE_HEIGHT;
+        const int tileX1 = tileX0 + OCCLUSION_TILE_WIDTH - 1;
+        const int tileY1 = tileY0 + OCCLUSION_TILE_HEIGHT - 1;
+
+        for (const uint32_t triIndex : bin) {
+            const auto& tri = m_Triangles[triIndex];
+            // 4 pixel groups, the pixels outside of the triangle fail the edge test anyway
+            const int minX = std::max(tri.m_MinX, tileX0) & ~3;
+            const int maxX = std::min(tri.m_MaxX, tileX1);
+            const int minY = std::max(tri.m_MinY, tileY0);
+            const int maxY = std::min(tri.m_MaxY, tileY1);
+
+            for (int y = minY; y <= maxY; y++) {
+                const float py = static_cast<float>(y) + 0.5f;
+                float* row = m_Depth.data() + static_cast<size_t>(y) * m_Width;
+
+#ifdef REAL_OCCLUSION_SSE
+                if (m_SIMD) {
+                    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 depth = _mm_set1_ps(tri.m_MaxDepth);
+                    __m128 a[3], rowC[3];
+                    for (int e = 0; e < 3; e++) {
+                        a[e] = _mm_set1_ps(tri.m_A[e]);
+                        rowC[e] = _mm_set1_ps(tri.m_B[e] * py + tri.m_C[e]);
+                    }
+
+                    for (int x = minX; x <= maxX; x += 4) {
+                        const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                        __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[0], px), rowC[0]), zero);
+                        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[1], px), rowC[1]), zero));
+                        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[2], px), rowC[2]), zero));
+                        if (_mm_movemask_ps(inside) == 0) continue;
+
+                        const __m128 old = _mm_loadu_ps(row + x);
+                        const __m128 nearer = _mm_min_ps(old, depth);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+                    }
+                    continue;
+                }
+#endif
+                // Same operation order as the SSE path, both give the same bits
+                float rowC[3];
+                for (int e = 0; e < 3; e++) rowC[e] = tri.m_B[e] * py + tri.m_C[e];
+
+                for (int x = minX; x <= maxX; x++) {
+                    const float px = static_cast<float>(x) + 0.5f;
+                    bool inside = true;
+                    for (int e = 0; e < 3; e++) {
+                        inside &= tri.m_A[e] * px + rowC[e] >= 0.0f;
+                    }
+                    if (inside) row[x] = std::min(row[x], tri.m_MaxDepth);
+                }
+            }
+        }
+
+        float tileMax = 0.0f;
+        for (int y = tileY0; y <= tileY1; y++) {
+            const float* row = m_Depth.data() + static_cast<size_t>(y) * m_Width;
+            tileMax = std::max(tileMax, *std::max_element(row + tileX0, row + tileX1 + 1));
+        }
+        m_TileMaxDepth[tile] = tileMax;
+    }
+
+    bool OcclusionBuffer::IsVisible(const AABB &bounds, const glm::mat4 &model) const {
+        const glm::mat4 mvp = m_ViewProjection * model;
+        float minX = static_cast<float>(m_Width), minY = static_cast<float>(m_Height), maxX = 0.0f, maxY = 0.0f;
+        float minDepth = 1.0f;
+
+        for (int corner = 0; corner < 8; corner++) {
+            const glm::vec3 local(corner & 1 ? bounds.m_Max.x : bounds.m_Min.x,
+                                  corner & 2 ? bounds.m_Max.y : bounds.m_Min.y,
+                                  corner & 4 ? bounds.m_Max.z : bounds.m_Min.z);
+            const glm::vec4 clip = mvp * glm::vec4(local, 1.0f);
+            // Crossing the near plane, the camera is (almost) inside of it
+            if (clip.w <= NEAR_W_EPSILON || clip.z < -clip.w) return true;
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            const float x = (ndc.x * 0.5f + 0.5f) * static_cast<float>(m_Width);
+            const float y = (ndc.y * 0.5f + 0.5f) * static_cast<float>(m_Height);
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+            minDepth = std::min(minDepth, ndc.z * 0.5f + 0.5f);
+        }
+
+        // Outside of the view is the frustum test's business
+        if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(m_Width) || minY >= static_cast<float>(m_Height))
+            return true;
+
+        // Grown by a pixel, the occluders are sampled at the pixel centers and may cover a bit more than they should
+        return IsRectVisible(
+            std::max(0, static_cast<int>(std::floor(minX)) - 1), std::max(0, static_cast<int>(std::floor(minY)) - 1),
+            std::min(static_cast<int>(m_Width) - 1, static_cast<int>(std::floor(maxX)) + 1),
+            std::min(static_cast<int>(m_Height) - 1, static_cast<int>(std::floor(maxY)) + 1),
+            minDepth
+        );
+    }
+
+    bool OcclusionBuffer::IsRectVisible(int minX, int minY, int maxX, int maxY, float minDepth) const {
+        const int tileMinX = minX / OCCLUSION_TILE_WIDTH,  tileMaxX = maxX / OCCLUSION_TILE_WIDTH;
+        const int tileMinY = minY / OCCLUSION_TILE_HEIGHT, tileMaxY = maxY / OCCLUSION_TILE_HEIGHT;
+
+        for (int ty = tileMinY; ty <= tileMaxY; ty++) {
+            for (int tx = tileMinX; tx <= tileMaxX; tx++) {
+                // Whole tile is nearer than the box
+                if (minDepth > m_TileMaxDepth[ty * m_TilesX + tx]) continue;
+
+                const int x0 = std::max(minX, tx * OCCLUSION_TILE_WIDTH);
+                const int x1 = std::min(maxX, (tx + 1) * OCCLUSION_TILE_WIDTH - 1);
+                const int y0 = std::max(minY, ty * OCCLUSION_TILE_HEIGHT);
+                const int y1 = std::min(maxY, (ty + 1) * OCCLUSION_TILE_HEIGHT - 1);
+                for (int y = y0; y <= y1; y++) {
+                    const float* row = m_Depth.data() + static_cast<size_t>(y) * m_Width;
+                    for (int x = x0; x <= x1; x++) {
+                        if (minDepth <= row[x]) return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+}
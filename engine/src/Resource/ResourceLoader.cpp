@@ -31,6 +31,8 @@ namespace Real {
         mm->LoadPrimitiveTypes();
 
         m_ModelLoader->LoadAll(std::string(ASSETS_SOURCE_DIR) + "models/");
+        // Compress the model textures all together
+        ai->FlushCompressionQueue();
 
         // If there are new assets from the ModelLoader, upload them to the database!
         ai->LoadNewAssetsToDataBase();
@@ -38,7 +40,7 @@ namespace Real {
         // Load meshes after all the data processed
         mm->InitResources();
 
-        m_RenderContext->GetGPURenderData().textures = Services::GetAssetManager()->UploadTexturesToGPU();
+        m_RenderContext->SetBindlessTextures(Services::GetAssetManager()->UploadTexturesToGPU());
 
         Info("[ResourceLoader] Assets loaded successfully!");
     }
@@ -49,6 +51,8 @@ namespace Real {
         const auto vert = ConcatStr(SHADERS_DIR, "opengl/main.vert");
         const auto frag = ConcatStr(SHADERS_DIR, "opengl/main.frag");
         am->LoadShader(vert, frag, "main");
+        am->LoadComputeShader(ConcatStr(SHADERS_DIR, "opengl/cull.comp"), "cull");
+        am->LoadComputeShader(ConcatStr(SHADERS_DIR, "opengl/hiz.comp"), "hiz");
         Info("[ResourceLoader] Shaders loaded successfully!");
     }
 
@@ -2,23 +2,60 @@
 // Created by pointerlost on 10/24/25.
 //
 #include "Scene/SystemUpdate.h"
+#include "Common/Scheduling/TaskManager.h"
+#include "Core/RealConfig.h"
+#include "Core/Services.h"
 #include "Scene/Components.h"
 #include "Scene/Scene.h"
 
+namespace {
+
+    // Iterate a view, big views are split into chunks on the workers
+    // func must only touch the components of the given entity!
+    template <typename... Components, typename Func>
+    void ParallelEach(Real::Scene* scene, Func&& func) {
+        auto view = scene->GetAllEntitiesWith<Components...>();
+        const auto& tm = Real::Services::GetTaskManager();
+
+        // Leading storage size, upper bound of the view. size() is disabled for in_place storages (TransformComponent isn't movable)
+        const size_t count = view.handle() ? view.handle()->size() : 0;
+
+        if (!tm || count < SYSTEM_PARALLEL_CHUNK_SIZE) {
+            for (const auto entity : view) {
+                func(view.template get<Components>(entity)...);
+            }
+            return;
+        }
+
+        // Snapshot the entities, storage can't change during the update
+        std::vector<entt::entity> entities;
+        entities.reserve(count);
+        for (const auto entity : view) {
+            entities.push_back(entity);
+        }
+
+        tm->ParallelFor(entities.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                func(view.template get<Components>(entities[i])...);
+            }
+        }, SYSTEM_PARALLEL_CHUNK_SIZE);
+    }
+}
+
 namespace Real {
 
     void TransformUpdate::Update(Scene *scene, float deltaTime) {
-        const auto& view = scene->GetAllEntitiesWith<TransformComponent>();
-
-        for (const auto& [entity, transform] : view.each()) {
+        ParallelEach<TransformComponent>(scene, [](TransformComponent& transform) {
             transform.m_Transform.Update();
-        }
+        });
     }
 
-    void VelocityUpdate::Update(Scene *scene, float deltaTime) {
-        const auto& view = scene->GetAllEntitiesWith<VelocityComponent, TransformComponent>();
+    SystemAccess TransformUpdate::GetAccess() const {
+        return SystemAccess{}.Write<TransformComponent>();
+    }
 
-        for (const auto& [entity, vc, tc] : view.each()) {
+    void VelocityUpdate::Update(Scene *scene, float deltaTime) {
+        ParallelEach<VelocityComponent, TransformComponent>(scene, [](VelocityComponent& vc, TransformComponent& tc) {
             auto& transform = tc.m_Transform;
 
             vc.m_LinearVelocity = (
@@ -31,25 +68,38 @@ namespace Real {
             transform.AddTranslate(vc.m_LinearVelocity);
 
             // TODO: Add acceleration for rotation
-        }
+        });
+    }
+
+    SystemAccess VelocityUpdate::GetAccess() const {
+        return SystemAccess{}.Write<VelocityComponent, TransformComponent>();
     }
 
     void MeshRendererUpdate::Update(Scene *scene, float deltaTime) {
     }
 
-    void CameraUpdate::Update(Scene *scene, float deltaTime) {
-        const auto& view = scene->GetAllEntitiesWith<CameraComponent, TransformComponent>();
+    SystemAccess MeshRendererUpdate::GetAccess() const {
+        return SystemAccess{}.Read<MeshRendererComponent>();
+    }
 
-        for (const auto& [entity, camera, transform] : view.each()) {
+    void CameraUpdate::Update(Scene *scene, float deltaTime) {
+        ParallelEach<CameraComponent, TransformComponent>(scene, [](CameraComponent& camera, TransformComponent& transform) {
             camera.m_Camera.Update(transform.m_Transform);
-        }
+        });
     }
 
-    void LightUpdate::Update(Scene *scene, float deltaTime) {
-        const auto& view = scene->GetAllEntitiesWith<LightComponent, TransformComponent>();
+    SystemAccess CameraUpdate::GetAccess() const {
+        // Camera writes the direction vectors of its transform
+        return SystemAccess{}.Write<CameraComponent, TransformComponent>();
+    }
 
-        for (const auto& [entity, light, transform] : view.each()) {
+    void LightUpdate::Update(Scene *scene, float deltaTime) {
+        ParallelEach<LightComponent, TransformComponent>(scene, [](LightComponent& light, TransformComponent& transform) {
             light.m_Light.Update(transform.m_Transform);
-        }
+        });
+    }
+
+    SystemAccess LightUpdate::GetAccess() const {
+        return SystemAccess{}.Write<LightComponent>().Read<TransformComponent>();
     }
 }
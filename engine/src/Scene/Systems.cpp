@@ -2,22 +2,78 @@
 // Created by pointerlost on 10/24/25.
 //
 #include "Scene/Systems.h"
+#include <algorithm>
+#include "Common/Scheduling/TaskManager.h"
+#include "Core/Services.h"
 #include "Scene/SystemUpdate.h"
 
 namespace Real {
 
+    bool SystemAccess::ConflictsWith(const SystemAccess &other) const {
+        if (m_Exclusive || other.m_Exclusive)
+            return true;
+
+        // Write-Write or Read-Write on the same component
+        const auto Contains = [](const std::vector<entt::id_type>& ids, entt::id_type id) {
+            return std::ranges::find(ids, id) != ids.end();
+        };
+        for (const auto id : m_Writes) {
+            if (Contains(other.m_Writes, id) || Contains(other.m_Reads, id))
+                return true;
+        }
+        for (const auto id : m_Reads) {
+            if (Contains(other.m_Writes, id))
+                return true;
+        }
+        return false;
+    }
+
     void Systems::Init() {
         m_Updatables.push_back(CreateScope<CameraUpdate>());
         m_Updatables.push_back(CreateScope<TransformUpdate>());
         m_Updatables.push_back(CreateScope<VelocityUpdate>());
         m_Updatables.push_back(CreateScope<MeshRendererUpdate>());
         m_Updatables.push_back(CreateScope<LightUpdate>());
+
+        BuildDependencyGraph();
+    }
+
+    void Systems::BuildDependencyGraph() {
+        // Registration order is the execution order for the conflicting systems
+        m_Dependencies.assign(m_Updatables.size(), {});
+        for (size_t i = 0; i < m_Updatables.size(); i++) {
+            const auto access = m_Updatables[i]->GetAccess();
+            for (size_t j = 0; j < i; j++) {
+                if (access.ConflictsWith(m_Updatables[j]->GetAccess()))
+                    m_Dependencies[i].push_back(j);
+            }
+        }
     }
 
     void Systems::UpdateAll(Scene *scene, float deltaTime) const {
-        for (const auto& subSystem : m_Updatables) {
-            // Update sub-systems
-            subSystem->Update(scene, deltaTime);
+        const auto& tm = Services::GetTaskManager();
+        if (!tm) {
+            for (const auto& subSystem : m_Updatables) {
+                // Update sub-systems
+                subSystem->Update(scene, deltaTime);
+            }
+            return;
+        }
+
+        // Submit every system with its dependencies, the independent ones run concurrently
+        std::vector<JobHandle> handles(m_Updatables.size());
+        for (size_t i = 0; i < m_Updatables.size(); i++) {
+            std::vector<JobHandle> deps;
+            deps.reserve(m_Dependencies[i].size());
+            for (const auto dep : m_Dependencies[i]) {
+                deps.push_back(handles[dep]);
+            }
+
+            const auto& subSystem = m_Updatables[i];
+            handles[i] = tm->Submit([&subSystem, scene, deltaTime] {
+                subSystem->Update(scene, deltaTime);
+            }, deps);
         }
+        tm->WaitAll(handles);
     }
 }
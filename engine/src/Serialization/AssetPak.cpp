@@ -0,0 +1,173 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include "Serialization/AssetPak.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include "Core/Logger.h"
+#include "Math/Math.h"
+#include "Serialization/Binary.h"
+
+namespace Real::serialization {
+
+    // Packed members can't be bound to a reference, projections go by value
+    static uint64_t UUIDOf(const AssetPakMeshEntry& entry) { return entry.m_Header.m_UUID; }
+
+    bool AssetPak::Build(const std::string &path, std::span<const PakMeshSource> meshes, AssetPak &previous) {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<PakMeshSource> sorted(meshes.begin(), meshes.end());
+        std::ranges::sort(sorted, {}, &PakMeshSource::m_UUID);
+        const auto [first, last] = std::ranges::unique(sorted, {}, &PakMeshSource::m_UUID);
+        sorted.erase(first, last);
+
+        // Written next to it and renamed, a crash never leaves half a pak behind
+        const std::string tmpPath = path + ".tmp";
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file) {
+            Warn("[AssetPak] File can't opening: " + tmpPath);
+            return false;
+        }
+
+        AssetPakHeader header{};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t offset = sizeof(header);
+
+        const auto WritePayload = [&file, &offset](const void* data, uint64_t size) {
+            static constexpr char padding[ASSET_PAK_ALIGNMENT]{};
+            const uint64_t aligned = (offset + ASSET_PAK_ALIGNMENT - 1) & ~(ASSET_PAK_ALIGNMENT - 1);
+            file.write(padding, static_cast<std::streamsize>(aligned - offset));
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            offset = aligned + size;
+            return aligned;
+        };
+
+        std::vector<AssetPakMeshEntry> toc;
+        toc.reserve(sorted.size());
+        size_t looseCount = 0;
+        for (const auto& source : sorted) {
+            AssetPakMeshEntry entry{};
+
+            // Unchanged meshes are copied from the previous pak, only the new ones are read from the loose files
+            if (const auto mesh = previous.FindMesh(source.m_UUID)) {
+                entry.m_Header       = *mesh->m_Header;
+                entry.m_VertexData   = WritePayload(mesh->m_Vertices.data(), mesh->m_Vertices.size_bytes());
+                entry.m_IndexData    = WritePayload(mesh->m_Indices.data(), mesh->m_Indices.size_bytes());
+                entry.m_MeshletData  = WritePayload(mesh->m_Meshlets.data(), mesh->m_Meshlets.size_bytes());
+                entry.m_MeshletCount = mesh->m_Meshlets.size();
+            } else {
+                auto result = binary::LoadMesh(source.m_Binary);
+                if (result.header.m_IndexCount == 0) continue; // Missing or broken, LoadMesh warned already
+
+                if (result.header.m_VertexFormat != VertexFormat::COMPACT) {
+                    result.packedVertices = math::PackVertices(result.vertices, math::ToAABB(result.header));
+                    result.header.m_VertexFormat = VertexFormat::COMPACT;
+                }
+                result.header.m_Compression = MeshCompression::NONE;
+                result.header.m_PayloadSize = result.packedVertices.size() * sizeof(PackedVertex) + result.indices.size() * sizeof(uint32_t);
+                const auto meshlets = binary::LoadMeshlets(binary::MeshletPath(source.m_Binary));
+
+                entry.m_Header       = result.header;
+                entry.m_VertexData   = WritePayload(result.packedVertices.data(), result.packedVertices.size() * sizeof(PackedVertex));
+                entry.m_IndexData    = WritePayload(result.indices.data(), result.indices.size() * sizeof(uint32_t));
+                entry.m_MeshletData  = WritePayload(meshlets.data(), meshlets.size() * sizeof(Meshlet));
+                entry.m_MeshletCount = meshlets.size();
+                looseCount++;
+            }
+            entry.m_Header.m_UUID = source.m_UUID;
+            toc.push_back(entry);
+        }
+
+        header.m_MeshCount = static_cast<uint32_t>(toc.size());
+        header.m_TOCOffset = WritePayload(toc.data(), toc.size() * sizeof(AssetPakMeshEntry));
+        header.m_FileSize  = offset;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (!file) {
+            Warn("[AssetPak] Failed to write data: " + tmpPath);
+            return false;
+        }
+
+        // Windows can't replace a mapped file
+        previous.Close();
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            Warn("[AssetPak] Can't replace " + path + ", " + ec.message());
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        Info(std::format("[AssetPak] Packed {} meshes ({} from loose files, {:.1f} MB) in {:.1f} ms",
+            toc.size(), looseCount, static_cast<double>(offset) / (1024.0 * 1024.0), ms));
+        return true;
+    }
+
+    bool AssetPak::Open(const std::string &path) {
+        Close();
+        if (!m_File.Open(path)) return false;
+
+        const uint8_t* data = m_File.GetData();
+        const size_t size = m_File.GetSize();
+        const auto* header = reinterpret_cast<const AssetPakHeader*>(data);
+        if (size < sizeof(AssetPakHeader) || header->m_Magic != REAL_MAGIC || header->m_FourCC != ASSET_PAK_FOURCC ||
+            header->m_Version != ASSET_PAK_VERSION)
+        {
+            Close();
+            return false;
+        }
+
+        const uint64_t count = header->m_MeshCount;
+        bool valid = header->m_FileSize == size && header->m_TOCOffset + count * sizeof(AssetPakMeshEntry) <= size;
+        const auto* toc = reinterpret_cast<const AssetPakMeshEntry*>(data + header->m_TOCOffset);
+
+        // Checked once here, FindMesh trusts the entries
+        const auto InFile = [size](uint64_t offset, uint64_t bytes) {
+            return offset % ASSET_PAK_ALIGNMENT == 0 && offset <= size && bytes <= size - offset;
+        };
+        for (uint64_t i = 0; valid && i < count; i++) {
+            const auto& entry = toc[i];
+            valid = entry.m_Header.m_VertexFormat == VertexFormat::COMPACT && entry.m_Header.m_Compression == MeshCompression::NONE &&
+                entry.m_Header.m_VertexCount <= size && entry.m_Header.m_IndexCount <= size && entry.m_MeshletCount <= size &&
+                InFile(entry.m_VertexData, entry.m_Header.m_VertexCount * sizeof(PackedVertex)) &&
+                InFile(entry.m_IndexData, entry.m_Header.m_IndexCount * sizeof(uint32_t)) &&
+                InFile(entry.m_MeshletData, entry.m_MeshletCount * sizeof(Meshlet)) &&
+                (i == 0 || UUIDOf(toc[i - 1]) < UUIDOf(entry));
+        }
+        if (!valid) {
+            Warn("[AssetPak] Broken pak, it's going to be packed again: " + path);
+            Close();
+            return false;
+        }
+
+        m_Header = header;
+        m_TOC = toc;
+        return true;
+    }
+
+    void AssetPak::Close() {
+        m_File.Close();
+        m_Header = nullptr;
+        m_TOC = nullptr;
+    }
+
+    std::optional<PakMesh> AssetPak::FindMesh(uint64_t uuid) const {
+        if (!m_Header) return std::nullopt;
+
+        const std::span toc(m_TOC, m_Header->m_MeshCount);
+        const auto it = std::ranges::lower_bound(toc, uuid, {}, UUIDOf);
+        if (it == toc.end() || UUIDOf(*it) != uuid) return std::nullopt;
+
+        const uint8_t* data = m_File.GetData();
+        PakMesh mesh;
+        mesh.m_Header   = &it->m_Header;
+        mesh.m_Vertices = { reinterpret_cast<const PackedVertex*>(data + it->m_VertexData), it->m_Header.m_VertexCount };
+        mesh.m_Indices  = { reinterpret_cast<const uint32_t*>(data + it->m_IndexData), it->m_Header.m_IndexCount };
+        mesh.m_Meshlets = { reinterpret_cast<const Meshlet*>(data + it->m_MeshletData), it->m_MeshletCount };
+        return mesh;
+    }
+}
@@ -0,0 +1,341 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include "Serialization/AssetRegistry.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "Core/Logger.h"
+#include "Util/Util.h"
+
+namespace Real::serialization {
+
+    static constexpr const char* ASSET_KIND_KEYS[] = { "textures", "materials", "meshes", "models" };
+    static constexpr uint32_t EMPTY_SLOT = 0; // Slots keep record index + 1
+
+    // FNV-1a, good enough for the paths and it's the same on every platform
+    static uint64_t HashString(std::string_view str) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char c : str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Projection by value, the packed members can't be bound to references
+    static uint64_t KeyOf(const AssetIndexEntry& entry) {
+        return entry.m_Key;
+    }
+
+    static uint64_t AlignSection(uint64_t offset) {
+        return (offset + 7) & ~7ULL;
+    }
+
+    AssetRegistry::SourceStamp AssetRegistry::GetSourceStamp(const std::string &jsonPath) {
+        std::error_code ec;
+        SourceStamp stamp;
+        stamp.m_Size = std::filesystem::file_size(jsonPath, ec);
+        if (ec) return {};
+        stamp.m_Time = std::filesystem::last_write_time(jsonPath, ec).time_since_epoch().count();
+        if (ec) return {};
+        return stamp;
+    }
+
+    std::vector<uint8_t> AssetRegistry::Compile(const nlohmann::json &db, const SourceStamp &source) {
+        AssetRegistryHeader header;
+        header.m_SourceSize = source.m_Size;
+        header.m_SourceTime = source.m_Time;
+
+        std::vector<AssetRecord> records;
+        std::string strings;
+        std::unordered_map<std::string, AssetString> pooled; // Extensions, folders etc. are repeated a lot
+
+        const auto AddString = [&strings, &pooled](const std::string& str) {
+            if (const auto it = pooled.find(str); it != pooled.end())
+                return it->second;
+            const AssetString ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size()) };
+            strings.append(str);
+            pooled.emplace(str, ref);
+            return ref;
+        };
+
+        for (uint32_t kind = 0; kind < static_cast<uint32_t>(AssetKind::COUNT); kind++) {
+            header.m_KindBegin[kind] = static_cast<uint32_t>(records.size());
+
+            const auto section = db.find(ASSET_KIND_KEYS[kind]);
+            if (section == db.end() || !section->is_object()) continue;
+
+            for (const auto& [uuidStr, data] : section->items()) {
+                UUID uuid;
+                if (!util::TryParseUUID(uuidStr, uuid)) {
+                    Warn(std::format("[AssetRegistry] Invalid UUID in the {} DB: {}", ASSET_KIND_KEYS[kind], uuidStr));
+                    continue;
+                }
+
+                AssetRecord record;
+                record.m_UUID = static_cast<uint64_t>(uuid);
+                record.m_Kind = static_cast<AssetKind>(kind);
+
+                switch (record.m_Kind) {
+                    case AssetKind::TEXTURE:
+                        record.m_TextureType = static_cast<uint32_t>(util::TextureType_StringToEnum(data.value("type", "")));
+                        record.m_FormatState = static_cast<uint32_t>(util::ImageFormatState_StringToEnum(data.value("image_format_state", "")));
+                        record.m_Name      = AddString(data.value("name", "null"));
+                        record.m_Stem      = AddString(data.value("stem", "null"));
+                        record.m_Path      = AddString(data.value("path", "null"));
+                        record.m_Extension = AddString(data.value("extension", "null"));
+                        record.m_SourcePath = AddString(data.value("source_path", ""));
+                        record.m_SourceHash = data.value("source_hash", 0ULL);
+                        record.m_SourceStamp = data.value("source_stamp", 0ULL);
+                        record.m_SourceSettings = data.value("source_settings", 0ULL);
+                        record.m_Key = record.m_Path;
+                        break;
+                    case AssetKind::MATERIAL:
+                        record.m_Name = AddString(data.value("name", "Material"));
+                        record.m_Key  = record.m_Name;
+                        if (const auto t = data.find("textures"); t != data.end() && t->is_object()) {
+                            record.m_Flags |= ASSET_RECORD_HAS_TEXTURES;
+                            record.m_Textures[0] = t->value("albedo",   0ULL);
+                            record.m_Textures[1] = t->value("normal",   0ULL);
+                            record.m_Textures[2] = t->value("orm",      0ULL);
+                            record.m_Textures[3] = t->value("height",   0ULL);
+                            record.m_Textures[4] = t->value("emissive", 0ULL);
+                        }
+                        break;
+                    case AssetKind::MESH:
+                        record.m_Name   = AddString(data.value("name", ""));
+                        record.m_Binary = AddString(data.value("binary", ""));
+                        record.m_Key    = record.m_Binary;
+                        break;
+                    case AssetKind::MODEL:
+                        record.m_Name      = AddString(data.value("name", ""));
+                        record.m_Binary    = AddString(data.value("binary", ""));
+                        record.m_FileName  = AddString(data.value("file_name", ""));
+                        record.m_Stem      = AddString(data.value("file_stem", ""));
+                        record.m_Path      = AddString(data.value("file_path", ""));
+                        record.m_Extension = AddString(data.value("file_extension", ""));
+                        record.m_SourceHash = data.value("source_hash", 0ULL);
+                        record.m_SourceStamp = data.value("source_stamp", 0ULL);
+                        record.m_SourceSettings = data.value("source_settings", 0ULL);
+                        record.m_Key = record.m_Path;
+                        break;
+                    default: ;
+                }
+                records.push_back(record);
+            }
+        }
+        header.m_KindBegin[static_cast<uint32_t>(AssetKind::COUNT)] = static_cast<uint32_t>(records.size());
+        header.m_RecordCount = static_cast<uint32_t>(records.size());
+
+        std::vector<AssetIndexEntry> uuidIndex(records.size());
+        std::vector<AssetIndexEntry> sourceIndex;
+        for (uint32_t i = 0; i < records.size(); i++) {
+            uuidIndex[i] = { records[i].m_UUID, i };
+            if (records[i].m_SourceHash != 0)
+                sourceIndex.push_back({ records[i].m_SourceHash, i });
+        }
+        std::ranges::sort(uuidIndex, {}, KeyOf);
+        std::ranges::stable_sort(sourceIndex, {}, KeyOf);
+        header.m_SourceCount = static_cast<uint32_t>(sourceIndex.size());
+
+        // Open addressing, at most half full so the probes stay short
+        header.m_TableCapacity = std::bit_ceil(std::max<uint32_t>(16, header.m_RecordCount * 2));
+        const uint32_t mask = header.m_TableCapacity - 1;
+        std::vector<uint32_t> pathTable(header.m_TableCapacity, EMPTY_SLOT);
+        std::vector<uint32_t> nameTable(header.m_TableCapacity, EMPTY_SLOT);
+
+        const auto KeyString = [&strings](const AssetRecord& record) {
+            return std::string_view(strings).substr(record.m_Key.m_Offset, record.m_Key.m_Length);
+        };
+        for (uint32_t i = 0; i < records.size(); i++) {
+            auto& table = records[i].m_Kind == AssetKind::MATERIAL ? nameTable : pathTable;
+            const auto key = KeyString(records[i]);
+            uint32_t slot = static_cast<uint32_t>(HashString(key)) & mask;
+            bool duplicate = false;
+            while (table[slot] != EMPTY_SLOT) {
+                // First one wins, like the importer caches
+                if (KeyString(records[table[slot] - 1]) == key) {
+                    duplicate = true;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            if (!duplicate) table[slot] = i + 1;
+        }
+
+        header.m_RecordOffset    = AlignSection(sizeof(AssetRegistryHeader));
+        header.m_UUIDIndexOffset = AlignSection(header.m_RecordOffset + records.size() * sizeof(AssetRecord));
+        header.m_SourceIndexOffset = AlignSection(header.m_UUIDIndexOffset + uuidIndex.size() * sizeof(AssetIndexEntry));
+        header.m_PathTableOffset = AlignSection(header.m_SourceIndexOffset + sourceIndex.size() * sizeof(AssetIndexEntry));
+        header.m_NameTableOffset = AlignSection(header.m_PathTableOffset + pathTable.size() * sizeof(uint32_t));
+        header.m_StringOffset    = AlignSection(header.m_NameTableOffset + nameTable.size() * sizeof(uint32_t));
+        header.m_StringSize      = strings.size();
+
+        std::vector<uint8_t> blob(header.m_StringOffset + strings.size(), 0);
+        std::memcpy(blob.data(), &header, sizeof(header));
+        std::memcpy(blob.data() + header.m_RecordOffset,    records.data(),   records.size() * sizeof(AssetRecord));
+        std::memcpy(blob.data() + header.m_UUIDIndexOffset, uuidIndex.data(), uuidIndex.size() * sizeof(AssetIndexEntry));
+        std::memcpy(blob.data() + header.m_SourceIndexOffset, sourceIndex.data(), sourceIndex.size() * sizeof(AssetIndexEntry));
+        std::memcpy(blob.data() + header.m_PathTableOffset, pathTable.data(), pathTable.size() * sizeof(uint32_t));
+        std::memcpy(blob.data() + header.m_NameTableOffset, nameTable.data(), nameTable.size() * sizeof(uint32_t));
+        std::memcpy(blob.data() + header.m_StringOffset,    strings.data(),   strings.size());
+
+        return blob;
+    }
+
+    bool AssetRegistry::Write(const std::string &path, std::span<const uint8_t> registry) {
+        // Written next to it and renamed, a crash never leaves half a registry behind
+        const std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!file) {
+                Warn("[AssetRegistry] File can't opening: " + tmpPath);
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(registry.data()), static_cast<std::streamsize>(registry.size()));
+            if (!file) {
+                Warn("[AssetRegistry] Failed to write data: " + tmpPath);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            Warn("[AssetRegistry] Can't replace " + path + ", " + ec.message());
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetRegistry::Open(const std::string &path, const SourceStamp &source) {
+        Close();
+        if (!m_File.Open(path)) return false;
+        if (!Attach(m_File.GetData(), m_File.GetSize(), source)) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetRegistry::Open(std::vector<uint8_t> registry, const SourceStamp &source) {
+        Close();
+        m_Memory = std::move(registry);
+        if (!Attach(m_Memory.data(), m_Memory.size(), source)) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetRegistry::Attach(const uint8_t *data, size_t size, const SourceStamp &source) {
+        if (size < sizeof(AssetRegistryHeader)) return false;
+
+        const auto* header = reinterpret_cast<const AssetRegistryHeader*>(data);
+        if (header->m_Magic != REAL_MAGIC || header->m_FourCC != ASSET_REGISTRY_FOURCC || header->m_Version != ASSET_REGISTRY_VERSION)
+            return false;
+        if (header->m_SourceSize != source.m_Size || header->m_SourceTime != source.m_Time)
+            return false;
+
+        const uint64_t count = header->m_RecordCount;
+        uint32_t kindBegin[static_cast<uint32_t>(AssetKind::COUNT) + 1];
+        std::memcpy(kindBegin, header->m_KindBegin, sizeof(kindBegin));
+        const uint64_t tableBytes = static_cast<uint64_t>(header->m_TableCapacity) * sizeof(uint32_t);
+        const bool valid =
+            std::has_single_bit(header->m_TableCapacity) &&
+            kindBegin[static_cast<uint32_t>(AssetKind::COUNT)] == count &&
+            header->m_RecordOffset    + count * sizeof(AssetRecord)    <= size &&
+            header->m_SourceCount <= count &&
+            header->m_UUIDIndexOffset + count * sizeof(AssetIndexEntry) <= size &&
+            header->m_SourceIndexOffset + header->m_SourceCount * sizeof(AssetIndexEntry) <= size &&
+            header->m_PathTableOffset + tableBytes <= size &&
+            header->m_NameTableOffset + tableBytes <= size &&
+            header->m_StringOffset    + header->m_StringSize <= size &&
+            std::ranges::is_sorted(kindBegin);
+        if (!valid) {
+            Warn("[AssetRegistry] Broken registry, it's going to be recompiled");
+            return false;
+        }
+
+        m_Header    = header;
+        m_Records   = reinterpret_cast<const AssetRecord*>(data + header->m_RecordOffset);
+        m_UUIDIndex = reinterpret_cast<const AssetIndexEntry*>(data + header->m_UUIDIndexOffset);
+        m_SourceIndex = reinterpret_cast<const AssetIndexEntry*>(data + header->m_SourceIndexOffset);
+        m_PathTable = reinterpret_cast<const uint32_t*>(data + header->m_PathTableOffset);
+        m_NameTable = reinterpret_cast<const uint32_t*>(data + header->m_NameTableOffset);
+        m_Strings   = reinterpret_cast<const char*>(data + header->m_StringOffset);
+        return true;
+    }
+
+    void AssetRegistry::Close() {
+        m_File.Close();
+        m_Memory.clear();
+        m_Header    = nullptr;
+        m_Records   = nullptr;
+        m_UUIDIndex = nullptr;
+        m_SourceIndex = nullptr;
+        m_PathTable = nullptr;
+        m_NameTable = nullptr;
+        m_Strings   = nullptr;
+    }
+
+    std::span<const AssetRecord> AssetRegistry::GetRecords(AssetKind kind) const {
+        if (!m_Header || kind >= AssetKind::COUNT) return {};
+        const uint32_t begin = m_Header->m_KindBegin[static_cast<uint32_t>(kind)];
+        const uint32_t end   = m_Header->m_KindBegin[static_cast<uint32_t>(kind) + 1];
+        return { m_Records + begin, end - begin };
+    }
+
+    std::string_view AssetRegistry::GetString(const AssetString &str) const {
+        if (!m_Header || static_cast<uint64_t>(str.m_Offset) + str.m_Length > m_Header->m_StringSize) return {};
+        return { m_Strings + str.m_Offset, str.m_Length };
+    }
+
+    const AssetRecord* AssetRegistry::FindByUUID(uint64_t uuid) const {
+        if (!m_Header) return nullptr;
+        const std::span index(m_UUIDIndex, m_Header->m_RecordCount);
+        const auto it = std::ranges::lower_bound(index, uuid, {}, KeyOf);
+        if (it == index.end() || it->m_Key != uuid) return nullptr;
+        return &m_Records[it->m_Record];
+    }
+
+    const AssetRecord* AssetRegistry::FindBySourceHash(uint64_t hash, AssetKind kind) const {
+        if (!m_Header || hash == 0) return nullptr;
+        const std::span index(m_SourceIndex, m_Header->m_SourceCount);
+        // Same content can be cooked more than once (copies in different folders), the first one is enough
+        for (auto it = std::ranges::lower_bound(index, hash, {}, KeyOf); it != index.end() && it->m_Key == hash; ++it) {
+            if (m_Records[it->m_Record].m_Kind == kind)
+                return &m_Records[it->m_Record];
+        }
+        return nullptr;
+    }
+
+    const AssetRecord* AssetRegistry::FindByPath(std::string_view path) const {
+        return FindInTable(m_PathTable, path);
+    }
+
+    const AssetRecord* AssetRegistry::FindByName(std::string_view name) const {
+        return FindInTable(m_NameTable, name);
+    }
+
+    const AssetRecord* AssetRegistry::FindInTable(const uint32_t *table, std::string_view key) const {
+        if (!m_Header) return nullptr;
+        const uint32_t mask = m_Header->m_TableCapacity - 1;
+        uint32_t slot = static_cast<uint32_t>(HashString(key)) & mask;
+        // Never full, there is always an empty slot to stop at
+        while (table[slot] != EMPTY_SLOT) {
+            const uint32_t record = table[slot] - 1;
+            if (record < m_Header->m_RecordCount && GetString(m_Records[record].m_Key) == key)
+                return &m_Records[record];
+            slot = (slot + 1) & mask;
+        }
+        return nullptr;
+    }
+}
@@ -2,14 +2,116 @@
 // Created by pointerlost on 12/15/25.
 //
 #include <Serialization/Binary.h>
+#include <cstddef>
+#include <filesystem>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <zdict.h>
+#include <zstd.h>
 #include "Common/RealTypes.h"
-#include "Core/AssetManager.h"
 #include "Core/Logger.h"
+#include "Core/RealConfig.h"
 #include "Core/Utils.h"
+#include "Math/Math.h"
 
 namespace Real::serialization::binary {
 
+    // Created once and never replaced, the workers get a copy of the pointers under the lock
+    struct MeshDictionary {
+        std::mutex m_Mutex;
+        std::string m_Path = ASSETS_DIR "runtime/meshes/meshes.zdict";
+        bool m_Loaded = false;
+        ZSTD_CDict* m_Compress = nullptr;
+        ZSTD_DDict* m_Decompress = nullptr;
+        uint32_t m_ID = 0;
+
+        ~MeshDictionary() {
+            ZSTD_freeCDict(m_Compress);
+            ZSTD_freeDDict(m_Decompress);
+        }
+    };
+    static MeshDictionary s_MeshDictionary;
+
+    struct MeshDictionaryView {
+        const ZSTD_CDict* m_Compress = nullptr;
+        const ZSTD_DDict* m_Decompress = nullptr;
+        uint32_t m_ID = 0;
+    };
+
+    // Lock is held by the caller
+    static void SetMeshDictionary(std::span<const uint8_t> dictionary) {
+        s_MeshDictionary.m_Compress   = ZSTD_createCDict(dictionary.data(), dictionary.size(), MESH_COMPRESSION_LEVEL);
+        s_MeshDictionary.m_Decompress = ZSTD_createDDict(dictionary.data(), dictionary.size());
+        s_MeshDictionary.m_ID         = ZDICT_getDictID(dictionary.data(), dictionary.size());
+    }
+
+    static MeshDictionaryView ViewMeshDictionary() {
+        std::lock_guard lock(s_MeshDictionary.m_Mutex);
+        if (!s_MeshDictionary.m_Loaded) {
+            s_MeshDictionary.m_Loaded = true;
+            std::ifstream file(s_MeshDictionary.m_Path, std::ios::binary | std::ios::in);
+            const std::vector<uint8_t> dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!dictionary.empty()) SetMeshDictionary(dictionary);
+        }
+        return { s_MeshDictionary.m_Compress, s_MeshDictionary.m_Decompress, s_MeshDictionary.m_ID };
+    }
+
+    // Vertices and indices are two frames back to back, each one is decompressed straight into its vector
+    // Empty if it doesn't get smaller
+    static std::vector<char> CompressPayload(std::span<const char> vertices, std::span<const char> indices) {
+        const size_t rawSize = vertices.size() + indices.size();
+        const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+        if (!ctx || rawSize == 0) return {};
+
+        const auto dictionary = ViewMeshDictionary();
+        const ZSTD_CDict* cdict = rawSize <= MESH_DICTIONARY_MAX_PAYLOAD ? dictionary.m_Compress : nullptr;
+
+        std::vector<char> compressed(ZSTD_compressBound(vertices.size()) + ZSTD_compressBound(indices.size()));
+        size_t size = 0;
+        for (const auto part : { vertices, indices }) {
+            const size_t result = cdict
+                ? ZSTD_compress_usingCDict(ctx.get(), compressed.data() + size, compressed.size() - size, part.data(), part.size(), cdict)
+                : ZSTD_compressCCtx(ctx.get(), compressed.data() + size, compressed.size() - size, part.data(), part.size(), MESH_COMPRESSION_LEVEL);
+            if (ZSTD_isError(result)) return {};
+            size += result;
+        }
+
+        if (size >= rawSize) return {};
+        compressed.resize(size);
+        return compressed;
+    }
+
+    static bool DecompressPayload(std::span<const char> compressed, std::span<char> vertices, std::span<char> indices) {
+        const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+        if (!ctx) return false;
+
+        const ZSTD_DDict* ddict = nullptr;
+        if (const unsigned dictionaryID = ZSTD_getDictID_fromFrame(compressed.data(), compressed.size())) {
+            const auto dictionary = ViewMeshDictionary();
+            if (!dictionary.m_Decompress || dictionary.m_ID != dictionaryID) {
+                Warn(std::format("[LoadMesh] Mesh dictionary {} is missing!", dictionaryID));
+                return false;
+            }
+            ddict = dictionary.m_Decompress;
+        }
+
+        for (const auto part : { vertices, indices }) {
+            const size_t frameSize = ZSTD_findFrameCompressedSize(compressed.data(), compressed.size());
+            if (ZSTD_isError(frameSize)) return false;
+
+            const size_t result = ddict
+                ? ZSTD_decompress_usingDDict(ctx.get(), part.data(), part.size(), compressed.data(), frameSize, ddict)
+                : ZSTD_decompressDCtx(ctx.get(), part.data(), part.size(), compressed.data(), frameSize);
+            if (ZSTD_isError(result) || result != part.size()) {
+                Warn(std::string("[LoadMesh] ") + (ZSTD_isError(result) ? ZSTD_getErrorName(result) : "Payload size mismatch"));
+                return false;
+            }
+            compressed = compressed.subspan(frameSize);
+        }
+        return true;
+    }
+
     void WriteModel(const std::string &path, ModelBinaryHeader binaryHeader,
         const std::vector<UUID>& meshUUIDs, const std::vector<UUID>& materialUUIDs)
     {
@@ -105,27 +207,36 @@ namespace Real::serialization::binary {
         return std::make_tuple(header, meshUUIDs, materialUUIDs);
     }
 
-    void WriteMesh(const std::string &path, const MeshBinaryHeader &binaryHeader,
-        const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    // Vertex layout is decided by the header, the file structure is the same for both
+    static void WriteMeshFile(const std::string &path, const MeshBinaryHeader &binaryHeader,
+        const char* vertices, size_t verticesSize, const std::vector<uint32_t>& indices, bool compress)
     {
         std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::trunc);
         if (!file) {
             Warn("[Write] Mesh binary file can't opening: " + path);
             return;
         }
-
-        file.write(reinterpret_cast<const char*>(&binaryHeader), sizeof(binaryHeader));
-
-        if (!vertices.empty()) {
-            file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(Vertex));
-        } else {
-            Warn("[WriteMesh] Vertices are empty!");
+        if (verticesSize == 0) Warn("[WriteMesh] Vertices are empty!");
+        if (indices.empty())   Warn("[WriteMesh] Indices are empty!");
+
+        const std::span<const char> vertexBytes(vertices, verticesSize);
+        const std::span<const char> indexBytes(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+        std::vector<char> compressed;
+        if (compress) {
+            compressed = CompressPayload(vertexBytes, indexBytes);
         }
 
-        if (!indices.empty()) {
-            file.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+        MeshBinaryHeader header = binaryHeader;
+        header.m_Version     = MESH_BINARY_VERSION;
+        header.m_Compression = compressed.empty() ? MeshCompression::NONE : MeshCompression::ZSTD;
+        header.m_PayloadSize = compressed.empty() ? vertexBytes.size() + indexBytes.size() : compressed.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!compressed.empty()) {
+            file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
         } else {
-            Warn("[WriteMesh] Indices are empty!");
+            file.write(vertexBytes.data(), static_cast<std::streamsize>(vertexBytes.size()));
+            file.write(indexBytes.data(), static_cast<std::streamsize>(indexBytes.size()));
         }
 
         if (!file) {
@@ -133,6 +244,28 @@ namespace Real::serialization::binary {
         }
     }
 
+    void WriteMesh(const std::string &path, const MeshBinaryHeader &binaryHeader,
+        const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool compress)
+    {
+        if (binaryHeader.m_VertexFormat != VertexFormat::FLOAT32) {
+            Warn("[WriteMesh] Header format doesn't match the vertices (expected FLOAT32): " + path);
+            return;
+        }
+        WriteMeshFile(path, binaryHeader, reinterpret_cast<const char*>(vertices.data()),
+            vertices.size() * sizeof(Vertex), indices, compress);
+    }
+
+    void WriteMesh(const std::string &path, const MeshBinaryHeader &binaryHeader,
+        std::span<const PackedVertex> vertices, const std::vector<uint32_t>& indices, bool compress)
+    {
+        if (binaryHeader.m_VertexFormat != VertexFormat::COMPACT) {
+            Warn("[WriteMesh] Header format doesn't match the vertices (expected COMPACT): " + path);
+            return;
+        }
+        WriteMeshFile(path, binaryHeader, reinterpret_cast<const char*>(vertices.data()),
+            vertices.size_bytes(), indices, compress);
+    }
+
     MeshLoadResult LoadMesh(const std::string &path) {
         std::ifstream file(path, std::ios::binary | std::ios::in);
         if (!file) {
@@ -141,7 +274,11 @@ namespace Real::serialization::binary {
         }
 
         MeshLoadResult result{};
-        file.read(reinterpret_cast<char*>(&result.header), sizeof(MeshBinaryHeader));
+        // Older headers are prefixes of the current one, every version appends its fields
+        constexpr auto v1HeaderSize = offsetof(MeshBinaryHeader, m_BoundsMin);
+        constexpr auto v2HeaderSize = offsetof(MeshBinaryHeader, m_VertexFormat);
+        constexpr auto v3HeaderSize = offsetof(MeshBinaryHeader, m_Compression);
+        file.read(reinterpret_cast<char*>(&result.header), v1HeaderSize);
 
         // Validate REAL magic numbers
         if (result.header.m_Magic != MakeFourCC('R', 'E', 'A', 'L')) {
@@ -149,18 +286,34 @@ namespace Real::serialization::binary {
             return {};
         }
 
-        if (result.header.m_VertexCount > 0) {
-            result.vertices.resize(result.header.m_VertexCount);
-            file.read(reinterpret_cast<char*>(result.vertices.data()),
-                        result.header.m_VertexCount * sizeof(Vertex)
-            );
+        const bool hasBounds = result.header.m_Version >= 2;
+        if (hasBounds) {
+            const auto headerSize = result.header.m_Version >= 4 ? sizeof(MeshBinaryHeader) :
+                                    result.header.m_Version >= 3 ? v3HeaderSize : v2HeaderSize;
+            file.read(reinterpret_cast<char*>(&result.header) + v1HeaderSize, headerSize - v1HeaderSize);
         }
 
-        if (result.header.m_IndexCount > 0) {
-            result.indices.resize(result.header.m_IndexCount);
-            file.read(reinterpret_cast<char*>(result.indices.data()),
-                        result.header.m_IndexCount * sizeof(uint32_t)
-            );
+        std::span<char> vertexBytes;
+        if (result.header.m_VertexFormat == VertexFormat::COMPACT) {
+            result.packedVertices.resize(result.header.m_VertexCount);
+            vertexBytes = { reinterpret_cast<char*>(result.packedVertices.data()), result.header.m_VertexCount * sizeof(PackedVertex) };
+        } else {
+            result.vertices.resize(result.header.m_VertexCount);
+            vertexBytes = { reinterpret_cast<char*>(result.vertices.data()), result.header.m_VertexCount * sizeof(Vertex) };
+        }
+        result.indices.resize(result.header.m_IndexCount);
+        const std::span<char> indexBytes(reinterpret_cast<char*>(result.indices.data()), result.header.m_IndexCount * sizeof(uint32_t));
+
+        if (result.header.m_Compression == MeshCompression::ZSTD) {
+            std::vector<char> compressed(result.header.m_PayloadSize);
+            file.read(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            if (!file || !DecompressPayload(compressed, vertexBytes, indexBytes)) {
+                Warn("[LoadMesh] Failed to decompress data! " + path);
+                return {};
+            }
+        } else {
+            file.read(vertexBytes.data(), static_cast<std::streamsize>(vertexBytes.size()));
+            file.read(indexBytes.data(), static_cast<std::streamsize>(indexBytes.size()));
         }
 
         if (!file) {
@@ -168,7 +321,104 @@ namespace Real::serialization::binary {
             return {};
         }
 
+        // Old binaries have no bounds, compute them once here
+        if (!hasBounds) {
+            math::WriteAABB(math::ComputeAABB(result.vertices), result.header);
+            result.header.m_Version = MESH_BINARY_VERSION;
+        }
+
         return result;
     }
 
+    bool SetMeshDictionaryPath(const std::string &path) {
+        std::lock_guard lock(s_MeshDictionary.m_Mutex);
+        if (s_MeshDictionary.m_Loaded) {
+            Warn("[SetMeshDictionaryPath] Mesh dictionary is already in use: " + s_MeshDictionary.m_Path);
+            return false;
+        }
+        s_MeshDictionary.m_Path = path;
+        return true;
+    }
+
+    bool HasMeshDictionary() {
+        return ViewMeshDictionary().m_Decompress != nullptr;
+    }
+
+    bool TrainMeshDictionary(std::span<const std::vector<uint8_t>> samples) {
+        if (samples.size() < MESH_DICTIONARY_MIN_SAMPLES || HasMeshDictionary()) return false;
+
+        std::vector<uint8_t> buffer;
+        std::vector<size_t> sizes;
+        sizes.reserve(samples.size());
+        for (const auto& sample : samples) {
+            buffer.insert(buffer.end(), sample.begin(), sample.end());
+            sizes.push_back(sample.size());
+        }
+
+        std::vector<uint8_t> dictionary(MESH_DICTIONARY_SIZE);
+        const size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(),
+            sizes.data(), static_cast<unsigned>(sizes.size()));
+        if (ZDICT_isError(size)) {
+            Warn(std::format("[TrainMeshDictionary] Training failed with {} samples: {}", samples.size(), ZDICT_getErrorName(size)));
+            return false;
+        }
+        dictionary.resize(size);
+
+        {
+            // Path can't change anymore, HasMeshDictionary loaded it
+            std::lock_guard lock(s_MeshDictionary.m_Mutex);
+            std::ofstream file(s_MeshDictionary.m_Path, std::ios::binary | std::ios::out | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(dictionary.data()), static_cast<std::streamsize>(dictionary.size()));
+            if (!file) {
+                Warn("[TrainMeshDictionary] Failed to write the dictionary: " + s_MeshDictionary.m_Path);
+                return false;
+            }
+            if (!s_MeshDictionary.m_Compress) SetMeshDictionary(dictionary);
+        }
+        Info(std::format("[TrainMeshDictionary] Mesh dictionary trained from {} small meshes ({} KB)", samples.size(), size / 1024));
+        return true;
+    }
+
+    std::string MeshletPath(const std::string &meshBinaryPath) {
+        return std::filesystem::path(meshBinaryPath).replace_extension(".meshlets").string();
+    }
+
+    void WriteMeshlets(const std::string &path, const UUID &meshUUID, std::span<const Meshlet> meshlets) {
+        std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file) {
+            Warn("[Write] Meshlet binary file can't opening: " + path);
+            return;
+        }
+
+        MeshletBinaryHeader header{};
+        header.m_MeshUUID     = meshUUID;
+        header.m_MeshletCount = meshlets.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(meshlets.data()), static_cast<std::streamsize>(meshlets.size_bytes()));
+
+        if (!file) {
+            Warn("[WriteMeshlets] Failed to write data!");
+        }
+    }
+
+    std::vector<Meshlet> LoadMeshlets(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::in);
+        if (!file) return {};
+
+        MeshletBinaryHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (header.m_Magic != MakeFourCC('R', 'E', 'A', 'L')) {
+            Warn("Real Magic number mismatch! " + path);
+            return {};
+        }
+
+        std::vector<Meshlet> meshlets(header.m_MeshletCount);
+        file.read(reinterpret_cast<char*>(meshlets.data()), static_cast<std::streamsize>(meshlets.size() * sizeof(Meshlet)));
+        if (!file) {
+            Warn("[LoadMeshlets] Failed to read data!");
+            return {};
+        }
+        return meshlets;
+    }
+
 }
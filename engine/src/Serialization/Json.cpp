@@ -9,17 +9,18 @@
 
 namespace Real::serialization::json {
 
-    void Save(const std::string &path, const nlohmann::json &j) {
+    bool Save(const std::string &path, const nlohmann::json &j) {
         const std::string content = j.dump(4); // Serialize first
 
         std::ofstream file(path, std::ios::out | std::ios::binary);
         if (!file.is_open()) {
             Warn("[SaveJSON] Failed to open file: " + path);
-            return;
+            return false;
         }
 
         file.write(content.data(), content.size());
         file.flush();
+        return static_cast<bool>(file);
     }
 
     nlohmann::json Load(const std::string &path) {
@@ -14,11 +14,18 @@
 #include "Util/Util.h"
 #include <Tools/DDS.h>
 #include <algorithm>
+#include <mutex>
 #include "Core/file_manager.h"
 #include "Core/Services.h"
 
 namespace Real::tools {
 
+    void InitCompressonator() {
+        // Init framework plugin and IO interfaces, once per process is enough
+        static std::once_flag s_InitFlag;
+        std::call_once(s_InitFlag, [] { CMP_InitFramework(); });
+    }
+
     Ref<OpenGLTexture> PackTexturesToRGBChannels(const Ref<OpenGLTexture> &ao,
         const Ref<OpenGLTexture> &rgh, const Ref<OpenGLTexture> &mtl, const std::string& materialName)
     {
@@ -146,8 +153,7 @@ namespace Real::tools {
         const auto [width, height] = texture->GetResolution(0);
         const auto channelCount    = texture->GetLevelData(0).m_ChannelCount;
 
-        // Init framework plugin and IO interfaces
-        CMP_InitFramework();
+        InitCompressonator();
         CMP_ERROR cmp_status = CMP_OK;
         CMP_MipSet MipSetIn  = {};
         CMP_MipSet MipSetCmp = {};
@@ -255,8 +261,7 @@ namespace Real::tools {
         const auto [width, height] = texture->GetResolution(0);
         const auto channelCount = texture->GetLevelData(0).m_ChannelCount;
 
-        // Init framework plugin and IO interfaces
-        CMP_InitFramework();
+        InitCompressonator();
         CMP_MipSet MipSetIn   = {};
         CMP_MipSet MipSetCmp  = {};
         CMP_ERROR  cmp_status = {};
@@ -0,0 +1,123 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include "Util/Hash.h"
+#include <cstring>
+#include <filesystem>
+#include "Core/file_manager.h"
+
+namespace Real::util {
+
+    static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t RotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static uint64_t Read64(const uint8_t* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint32_t Read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t Round(uint64_t acc, uint64_t input) {
+        acc += input * PRIME64_2;
+        acc  = RotateLeft(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    static uint64_t MergeRound(uint64_t acc, uint64_t value) {
+        acc ^= Round(0, value);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+
+    uint64_t XXH64(const void *data, size_t size, uint64_t seed) {
+        const auto* p   = static_cast<const uint8_t*>(data);
+        const auto* end = p + size;
+        uint64_t hash;
+
+        if (size >= 32) {
+            // Four lanes over 32 byte stripes
+            uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+            uint64_t v2 = seed + PRIME64_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME64_1;
+            const auto* limit = end - 32;
+            do {
+                v1 = Round(v1, Read64(p));      p += 8;
+                v2 = Round(v2, Read64(p));      p += 8;
+                v3 = Round(v3, Read64(p));      p += 8;
+                v4 = Round(v4, Read64(p));      p += 8;
+            } while (p <= limit);
+
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        } else {
+            hash = seed + PRIME64_5;
+        }
+        hash += size;
+
+        // Tail
+        for (; p + 8 <= end; p += 8) {
+            hash ^= Round(0, Read64(p));
+            hash  = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+        }
+        if (p + 4 <= end) {
+            hash ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+            hash  = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+            p += 4;
+        }
+        for (; p < end; p++) {
+            hash ^= *p * PRIME64_5;
+            hash  = RotateLeft(hash, 11) * PRIME64_1;
+        }
+
+        // Avalanche
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    bool TryHashFile(const std::string &path, uint64_t &hash, uint64_t seed) {
+        fs::MappedFile file;
+        if (file.Open(path)) {
+            hash = XXH64(file.GetData(), file.GetSize(), seed);
+            return true;
+        }
+        // Empty files can't be mapped
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(path, ec) && std::filesystem::file_size(path, ec) == 0 && !ec) {
+            hash = XXH64(nullptr, 0, seed);
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t HashFileStamp(const std::string &path) {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) return 0;
+        const auto time = std::filesystem::last_write_time(path, ec);
+        if (ec) return 0;
+
+        const uint64_t values[] = { size, static_cast<uint64_t>(time.time_since_epoch().count()) };
+        const uint64_t stamp = XXH64(values, sizeof(values));
+        return stamp != 0 ? stamp : 1;
+    }
+}
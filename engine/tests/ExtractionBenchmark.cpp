@@ -0,0 +1,186 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "Common/RealTypes.h"
+#include "Common/SlotMap.h"
+#include "Core/UUID.h"
+#include "Core/Utils.h"
+
+// Resolve step of RenderContext::RebuildDrawCommands, before and after the generational handles
+// Before: every renderable looked up its mesh and material by UUID in hash maps
+// After: handles are resolved once, the rebuild indexes the slot maps and a vector material cache
+// The real rebuild needs a GL context, this replays the same lookups with the same store sizes
+// Not registered to ctest, run it by hand from a release build
+
+namespace {
+    using namespace Real;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 9;
+
+    // Stand-in for MaterialInstance, the slot map only stores a Ref to it like AssetManager does
+    struct FakeMaterial {
+        uint32_t m_GPUData = 0;
+    };
+
+    struct Renderable {
+        UUID meshUUID;
+        UUID materialUUID;
+        MeshHandle mesh;
+        Handle<FakeMaterial> material;
+    };
+
+    struct Stores {
+        std::unordered_map<UUID, MeshAsset> meshesByUUID;
+        std::unordered_map<UUID, Ref<FakeMaterial>> materialsByUUID;
+        SlotMap<MeshAsset> meshes;
+        SlotMap<Ref<FakeMaterial>, FakeMaterial> materials;
+        std::vector<Renderable> renderables;
+    };
+
+    // Same LCG as the other tests, the entities pick their mesh and material in a scattered order
+    Stores MakeStores(uint32_t meshCount, uint32_t materialCount, uint32_t entityCount) {
+        Stores stores;
+        std::vector<std::pair<UUID, MeshHandle>> meshes;
+        std::vector<std::pair<UUID, Handle<FakeMaterial>>> materials;
+
+        for (uint32_t i = 0; i < meshCount; i++) {
+            const UUID uuid;
+            MeshAsset asset{ uuid, 36u + i, 36u + i, i * 64u, i * 64u, {} };
+            stores.meshesByUUID.emplace(uuid, asset);
+            meshes.emplace_back(uuid, stores.meshes.Insert(asset));
+        }
+        for (uint32_t i = 0; i < materialCount; i++) {
+            const UUID uuid;
+            const auto material = CreateRef<FakeMaterial>(FakeMaterial{ i });
+            stores.materialsByUUID.emplace(uuid, material);
+            materials.emplace_back(uuid, stores.materials.Insert(material));
+        }
+
+        uint32_t state = 12345;
+        const auto Random = [&state](uint32_t count) {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) % count;
+        };
+        for (uint32_t i = 0; i < entityCount; i++) {
+            const auto& [meshUUID, mesh] = meshes[Random(meshCount)];
+            const auto& [materialUUID, material] = materials[Random(materialCount)];
+            stores.renderables.push_back({ meshUUID, materialUUID, mesh, material });
+        }
+        return stores;
+    }
+
+    // Batch grouping is the same on both paths, only the resolve step differs
+    struct Result {
+        size_t batches = 0;
+        uint64_t indexCount = 0;
+    };
+
+    Result ResolveByUUID(const Stores& stores) {
+        std::unordered_map<UUID, int> materialIdxCache;
+        std::vector<uint32_t> materials;
+        std::unordered_map<uint64_t, size_t> batchLookup;
+        Result result;
+
+        for (const auto& renderable : stores.renderables) {
+            const auto meshIt = stores.meshesByUUID.find(renderable.meshUUID);
+            if (meshIt == stores.meshesByUUID.end()) continue;
+
+            int materialIndex;
+            if (const auto cached = materialIdxCache.find(renderable.materialUUID); cached != materialIdxCache.end()) {
+                materialIndex = cached->second;
+            } else {
+                const auto matIt = stores.materialsByUUID.find(renderable.materialUUID);
+                if (matIt == stores.materialsByUUID.end()) continue;
+                materialIndex = static_cast<int>(materials.size());
+                materials.push_back(matIt->second->m_GPUData);
+                materialIdxCache.emplace(renderable.materialUUID, materialIndex);
+            }
+
+            const uint64_t key = static_cast<uint64_t>(renderable.meshUUID) ^ static_cast<uint64_t>(materialIndex) << 48;
+            if (batchLookup.try_emplace(key, batchLookup.size()).second) result.batches++;
+            result.indexCount += meshIt->second.m_IndexCount;
+        }
+        return result;
+    }
+
+    Result ResolveByHandle(const Stores& stores) {
+        std::vector<int> materialIdxCache(stores.materials.Capacity(), -1);
+        std::vector<uint32_t> materials;
+        std::unordered_map<uint64_t, size_t> batchLookup;
+        Result result;
+
+        for (const auto& renderable : stores.renderables) {
+            const auto* meshData = stores.meshes.Get(renderable.mesh);
+            if (!meshData) continue;
+
+            auto& cached = materialIdxCache[renderable.material.m_Index];
+            if (cached < 0) {
+                const auto* material = stores.materials.Get(renderable.material);
+                if (!material) continue;
+                cached = static_cast<int>(materials.size());
+                materials.push_back((*material)->m_GPUData);
+            }
+
+            const uint64_t key = static_cast<uint64_t>(renderable.mesh.m_Index) << 32 | static_cast<uint32_t>(cached);
+            if (batchLookup.try_emplace(key, batchLookup.size()).second) result.batches++;
+            result.indexCount += meshData->m_IndexCount;
+        }
+        return result;
+    }
+
+    // Median of the runs in milliseconds
+    double Measure(const std::function<Result()>& run, Result& result) {
+        std::vector<double> times;
+        for (int i = 0; i < RUNS; i++) {
+            const auto start = Clock::now();
+            result = run();
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    struct Workload {
+        uint32_t meshCount;
+        uint32_t materialCount;
+        uint32_t entityCount;
+    };
+}
+
+int main() {
+    const Workload workloads[] = {
+        { 64,   16,   1000   },
+        { 512,  128,  16384  },
+        { 4096, 1024, 131072 },
+    };
+
+    std::printf("Draw command resolve step, median of %d runs\n", RUNS);
+    std::printf("%8s %8s %9s %9s %10s %10s %9s\n", "meshes", "mats", "entities", "batches", "UUID ms", "handle ms", "speedup");
+
+    bool mismatch = false;
+    for (const auto& [meshCount, materialCount, entityCount] : workloads) {
+        const auto stores = MakeStores(meshCount, materialCount, entityCount);
+
+        Result byUUID, byHandle;
+        const double uuidMs   = Measure([&] { return ResolveByUUID(stores); }, byUUID);
+        const double handleMs = Measure([&] { return ResolveByHandle(stores); }, byHandle);
+        if (byUUID.batches != byHandle.batches || byUUID.indexCount != byHandle.indexCount) mismatch = true;
+
+        std::printf("%8u %8u %9u %9zu %10.3f %10.3f %8.1fx\n",
+            meshCount, materialCount, entityCount, byHandle.batches, uuidMs, handleMs, uuidMs / handleMs);
+    }
+
+    if (mismatch) {
+        std::printf("UUID and handle paths built different batches!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+#include "Serialization/Binary.h"
+#include "TestMeshes.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// Loads the same meshes from raw and zstd compressed binaries, with a cold and a warm page cache
+// The folder should be on a real disk (default is the working directory), tmpfs has no cold cache
+// Not registered to ctest, run it by hand from a release build: mesh_load_benchmark [folder]
+
+namespace {
+    using namespace Real;
+    using namespace Real::tests;
+    namespace binary = serialization::binary;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 5;
+
+    // Drops the pages of the file so the next read hits the disk (Linux only)
+    bool EvictFromPageCache(const std::string& path) {
+#ifdef _WIN32
+        return false;
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        fdatasync(fd);
+        const bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fd);
+        return evicted;
+#endif
+    }
+
+    struct MeshSet {
+        const char* name;
+        std::vector<std::string> paths;
+        uintmax_t bytes = 0;
+    };
+
+    MeshSet WriteSet(const char* name, const std::filesystem::path& folder, std::span<const TestMesh> meshes, bool compress) {
+        MeshSet set{ name };
+        std::filesystem::create_directories(folder);
+        for (size_t i = 0; i < meshes.size(); i++) {
+            const auto path = (folder / (std::to_string(i) + ".bin")).string();
+            binary::WriteMesh(path, meshes[i].header, std::span<const PackedVertex>(meshes[i].packed), meshes[i].indices, compress);
+            set.bytes += std::filesystem::file_size(path);
+            set.paths.push_back(path);
+        }
+        return set;
+    }
+
+    // Median of the runs in milliseconds, cold runs evict every file first
+    double Measure(const MeshSet& set, bool cold, bool& failed) {
+        std::vector<double> times;
+        for (int i = 0; i < RUNS; i++) {
+            if (cold) {
+                for (const auto& path : set.paths) {
+                    if (!EvictFromPageCache(path)) failed = true;
+                }
+            }
+
+            const auto start = Clock::now();
+            for (const auto& path : set.paths) {
+                if (binary::LoadMesh(path).indices.empty()) failed = true;
+            }
+            times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    const auto folder = std::filesystem::path(argc > 1 ? argv[1] : ".") / "mesh_load_benchmark";
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    binary::SetMeshDictionaryPath((folder / "meshes.zdict").string());
+
+    // Mostly small meshes (props) with a few big ones, like a typical scene
+    std::vector<TestMesh> meshes;
+    for (uint32_t i = 0; i < 512; i++) {
+        meshes.push_back(MakeGrid(8 + i % 40, 0.1f + 0.03f * static_cast<float>(i % 17), VertexFormat::COMPACT));
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+        meshes.push_back(MakeGrid(300 + i * 20, 0.02f + 0.01f * static_cast<float>(i), VertexFormat::COMPACT));
+    }
+
+    std::vector<std::vector<uint8_t>> samples;
+    for (const auto& mesh : meshes) {
+        auto sample = Sample(mesh);
+        if (sample.size() <= MESH_DICTIONARY_MAX_PAYLOAD) samples.push_back(std::move(sample));
+    }
+    binary::TrainMeshDictionary(samples);
+
+    const MeshSet sets[] = {
+        WriteSet("raw",        folder / "raw",        meshes, false),
+        WriteSet("compressed", folder / "compressed", meshes, true),
+    };
+
+    std::printf("%zu meshes, median of %d runs\n", meshes.size(), RUNS);
+    std::printf("%-12s %10s %10s %10s\n", "binaries", "MB", "cold ms", "warm ms");
+
+    bool failed = false;
+    for (const auto& set : sets) {
+        const double coldMs = Measure(set, true, failed);
+        const double warmMs = Measure(set, false, failed);
+        std::printf("%-12s %10.2f %10.2f %10.2f\n", set.name, static_cast<double>(set.bytes) / (1024.0 * 1024.0), coldMs, warmMs);
+    }
+
+    std::filesystem::remove_all(folder);
+
+    if (failed) {
+        std::printf("Some meshes failed to load or couldn't be evicted from the page cache!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+#include <zstd.h>
+#include "Serialization/Binary.h"
+#include "TestMeshes.h"
+
+// Mesh binaries written and read back through a temporary folder, the dictionary is trained there too
+// Returns non-zero if any check fails (ctest)
+
+#define REAL_CHECK(expr) Check((expr), #expr, __LINE__)
+
+namespace {
+    using namespace Real;
+    using namespace Real::tests;
+    namespace binary = serialization::binary;
+
+    int s_Failures = 0;
+
+    void Check(bool passed, const char* expr, int line) {
+        if (passed) return;
+        std::printf("FAILED (line %d): %s\n", line, expr);
+        s_Failures++;
+    }
+
+    void Write(const std::string& path, const TestMesh& mesh, bool compress) {
+        if (mesh.header.m_VertexFormat == VertexFormat::COMPACT) {
+            binary::WriteMesh(path, mesh.header, std::span<const PackedVertex>(mesh.packed), mesh.indices, compress);
+        } else {
+            binary::WriteMesh(path, mesh.header, mesh.vertices, mesh.indices, compress);
+        }
+    }
+
+    bool SameMesh(const TestMesh& mesh, const MeshLoadResult& loaded) {
+        if (loaded.indices != mesh.indices) return false;
+        if (mesh.header.m_VertexFormat == VertexFormat::COMPACT) {
+            return loaded.packedVertices.size() == mesh.packed.size() &&
+                std::memcmp(loaded.packedVertices.data(), mesh.packed.data(), mesh.packed.size() * sizeof(PackedVertex)) == 0;
+        }
+        return loaded.vertices.size() == mesh.vertices.size() &&
+            std::memcmp(loaded.vertices.data(), mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) == 0;
+    }
+
+    // Dictionary ID of the first frame after the header, 0 if it was compressed without one
+    unsigned FrameDictionaryID(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::in);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() <= sizeof(MeshBinaryHeader)) return 0;
+        return ZSTD_getDictID_fromFrame(bytes.data() + sizeof(MeshBinaryHeader), bytes.size() - sizeof(MeshBinaryHeader));
+    }
+
+    void TestRoundTrip(const std::filesystem::path& folder, const TestMesh& mesh, bool compress, bool expectDictionary) {
+        const std::string path = (folder / "mesh.bin").string();
+        Write(path, mesh, compress);
+
+        const auto loaded = binary::LoadMesh(path);
+        REAL_CHECK(loaded.header.m_Compression == (compress ? MeshCompression::ZSTD : MeshCompression::NONE));
+        REAL_CHECK(SameMesh(mesh, loaded));
+        if (compress) {
+            REAL_CHECK((FrameDictionaryID(path) != 0) == expectDictionary);
+            const size_t vertexBytes = mesh.header.m_VertexFormat == VertexFormat::COMPACT
+                ? mesh.packed.size() * sizeof(PackedVertex) : mesh.vertices.size() * sizeof(Vertex);
+            REAL_CHECK(std::filesystem::file_size(path) < sizeof(MeshBinaryHeader) + vertexBytes + mesh.indices.size() * sizeof(uint32_t));
+        }
+    }
+
+    void TestDictionary(const std::filesystem::path& folder) {
+        // Path is taken before the dictionary is loaded for the first time
+        REAL_CHECK(binary::SetMeshDictionaryPath((folder / "meshes.zdict").string()));
+        REAL_CHECK(!binary::HasMeshDictionary());
+
+        const auto small = MakeGrid(12, 0.7f, VertexFormat::COMPACT);
+        const auto large = MakeGrid(96, 0.05f, VertexFormat::COMPACT);
+        REAL_CHECK(Sample(large).size() > MESH_DICTIONARY_MAX_PAYLOAD);
+
+        // Without a dictionary every payload is a plain zstd frame
+        TestRoundTrip(folder, small, true, false);
+
+        std::vector<std::vector<uint8_t>> samples;
+        for (uint32_t i = 0; i < MESH_DICTIONARY_MIN_SAMPLES * 4; i++) {
+            samples.push_back(Sample(MakeGrid(8 + i % 24, 0.1f + 0.05f * static_cast<float>(i % 13), VertexFormat::COMPACT)));
+        }
+        REAL_CHECK(!binary::TrainMeshDictionary(std::span(samples).first(MESH_DICTIONARY_MIN_SAMPLES - 1)));
+        REAL_CHECK(binary::TrainMeshDictionary(samples));
+        REAL_CHECK(binary::HasMeshDictionary());
+        REAL_CHECK(std::filesystem::exists(folder / "meshes.zdict"));
+        // Never replaced, the binaries written with it would be unreadable
+        REAL_CHECK(!binary::TrainMeshDictionary(samples));
+        REAL_CHECK(!binary::SetMeshDictionaryPath((folder / "other.zdict").string()));
+
+        // Small payloads use the dictionary, the big ones don't
+        TestRoundTrip(folder, small, true, true);
+        TestRoundTrip(folder, large, true, false);
+        TestRoundTrip(folder, MakeGrid(12, 0.7f, VertexFormat::FLOAT32), true, true);
+        TestRoundTrip(folder, small, false, false);
+    }
+}
+
+int main() {
+    const auto folder = std::filesystem::temp_directory_path() / "real_mesh_serialization_tests";
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+
+    TestDictionary(folder);
+
+    std::filesystem::remove_all(folder);
+
+    if (s_Failures > 0) {
+        std::printf("%d check(s) failed\n", s_Failures);
+        return 1;
+    }
+    std::printf("All mesh serialization checks passed\n");
+    return 0;
+}
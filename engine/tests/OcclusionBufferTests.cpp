@@ -0,0 +1,141 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include <glm/ext.hpp>
+#include "Common/Scheduling/TaskManager.h"
+#include "Math/OcclusionBuffer.h"
+
+// Headless, no window or GL context. Returns non-zero if any check fails (ctest)
+
+#define REAL_CHECK(expr) Check((expr), #expr, __LINE__)
+
+namespace {
+    using namespace Real;
+
+    int s_Failures = 0;
+
+    void Check(bool passed, const char* expr, int line) {
+        if (passed) return;
+        std::printf("FAILED (line %d): %s\n", line, expr);
+        s_Failures++;
+    }
+
+    // Camera at the origin looking down -Z, same aspect as the buffer
+    glm::mat4 ViewProjection(const math::OcclusionBuffer& buffer) {
+        const float aspect = static_cast<float>(buffer.GetWidth()) / static_cast<float>(buffer.GetHeight());
+        return glm::perspective(glm::radians(60.0f), aspect, 0.1f, 100.0f);
+    }
+
+    // 4x4 wall facing the camera at z = -10
+    void AddWall(math::OcclusionBuffer& buffer) {
+        const std::vector<glm::vec3> positions = { { -2, -2, -10 }, { 2, -2, -10 }, { 2, 2, -10 }, { -2, 2, -10 } };
+        const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        buffer.AddOccluder(positions, indices, glm::mat4(1.0f));
+    }
+
+    // Same random triangles every run, a simple LCG keeps it independent of the standard library
+    void AddTriangleSoup(math::OcclusionBuffer& buffer) {
+        uint32_t state = 12345;
+        const auto Random = [&state](float min, float max) {
+            state = state * 1664525u + 1013904223u;
+            return min + (max - min) * static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+        };
+
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < 300; i++) {
+            const glm::vec3 center(Random(-20, 20), Random(-10, 10), Random(-60, -5));
+            for (int v = 0; v < 3; v++) {
+                positions.push_back(center + glm::vec3(Random(-3, 3), Random(-3, 3), Random(-1, 1)));
+                indices.push_back(static_cast<uint32_t>(indices.size()));
+            }
+        }
+        buffer.AddOccluder(positions, indices, glm::mat4(1.0f));
+    }
+
+    bool SameDepth(const math::OcclusionBuffer& a, const math::OcclusionBuffer& b) {
+        if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight()) return false;
+        for (uint32_t y = 0; y < a.GetHeight(); y++) {
+            for (uint32_t x = 0; x < a.GetWidth(); x++) {
+                const float da = a.GetDepth(x, y), db = b.GetDepth(x, y);
+                if (std::memcmp(&da, &db, sizeof(float)) != 0) return false;
+            }
+        }
+        return true;
+    }
+
+    void TestBoxesAgainstWall() {
+        math::OcclusionBuffer buffer;
+        buffer.Begin(ViewProjection(buffer));
+        AddWall(buffer);
+        buffer.Rasterize();
+        REAL_CHECK(buffer.GetTriangleCount() == 2);
+
+        const AABB box{ glm::vec3(-0.5f), glm::vec3(0.5f) };
+        REAL_CHECK(!buffer.IsVisible(box, glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -20))));
+        REAL_CHECK(buffer.IsVisible(box, glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -5))));
+        // Wall edge (x = 2 at z = -10) is at x = 4 twice as far, the box is half out of it
+        REAL_CHECK(buffer.IsVisible(box, glm::translate(glm::mat4(1.0f), glm::vec3(4, 0, -20))));
+        REAL_CHECK(buffer.IsVisible(box, glm::translate(glm::mat4(1.0f), glm::vec3(0, 4, -20))));
+        // Crossing the near plane
+        REAL_CHECK(buffer.IsVisible(box, glm::mat4(1.0f)));
+    }
+
+    void TestScalarMatchesSIMD() {
+        if (!math::OcclusionBuffer::HasSIMD()) {
+            std::printf("SSE isn't compiled in, only the scalar path is tested\n");
+            return;
+        }
+
+        math::OcclusionBuffer simd, scalar;
+        scalar.SetSIMD(false);
+        for (auto* buffer : { &simd, &scalar }) {
+            buffer->Begin(ViewProjection(*buffer));
+            AddWall(*buffer);
+            AddTriangleSoup(*buffer);
+            buffer->Rasterize();
+        }
+        REAL_CHECK(SameDepth(simd, scalar));
+    }
+
+    void TestSerialMatchesParallel() {
+        TaskManager taskManager(4);
+        const auto Runner = [&taskManager](size_t count, const std::function<void(size_t, size_t)>& func) {
+            taskManager.ParallelFor(count, func, 1);
+        };
+
+        math::OcclusionBuffer serial, parallel;
+        for (auto* buffer : { &serial, &parallel }) {
+            buffer->Begin(ViewProjection(*buffer));
+            AddWall(*buffer);
+            AddTriangleSoup(*buffer);
+        }
+        serial.Rasterize();
+        parallel.Rasterize(Runner);
+        REAL_CHECK(SameDepth(serial, parallel));
+
+        // Begin clears everything, the next frame gives the same buffer again
+        parallel.Begin(ViewProjection(parallel));
+        AddWall(parallel);
+        AddTriangleSoup(parallel);
+        parallel.Rasterize(Runner);
+        REAL_CHECK(SameDepth(serial, parallel));
+    }
+}
+
+int main() {
+    TestBoxesAgainstWall();
+    TestScalarMatchesSIMD();
+    TestSerialMatchesParallel();
+
+    if (s_Failures > 0) {
+        std::printf("%d check(s) failed\n", s_Failures);
+        return 1;
+    }
+    std::printf("All occlusion buffer checks passed\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include "Common/Scheduling/TaskManager.h"
+#include "Common/Scheduling/Threads.h"
+
+// Fan-out/fan-in: N jobs write their own slot, then one reduction sums them up
+// Compares the job system with the old Thread path (one std::thread per job, joined in batches)
+// Not registered to ctest, run it by hand from a release build
+
+namespace {
+    using namespace Real;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 7;
+
+    // Busy work which the compiler can't fold, same result for the same job on every path
+    uint64_t Work(size_t job, uint32_t iterations) {
+        uint64_t state = job + 1;
+        for (uint32_t i = 0; i < iterations; i++) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        return state >> 33;
+    }
+
+    uint64_t Sum(const std::vector<uint64_t>& results) {
+        return std::accumulate(results.begin(), results.end(), uint64_t{0});
+    }
+
+    // Old path, the Thread class has no queue so at most workerCount threads are alive at once
+    uint64_t RunThreads(size_t jobCount, uint32_t iterations, int workerCount) {
+        std::vector<uint64_t> results(jobCount);
+        for (size_t first = 0; first < jobCount; first += workerCount) {
+            Thread threads(workerCount);
+            const size_t last = std::min(jobCount, first + workerCount);
+            for (size_t job = first; job < last; job++) {
+                threads.Submit([&results, job, iterations] { results[job] = Work(job, iterations); });
+            }
+            threads.JoinAll();
+        }
+        return Sum(results);
+    }
+
+    // One job per item, the reduction depends on all of them
+    uint64_t RunSubmit(TaskManager& tm, size_t jobCount, uint32_t iterations) {
+        std::vector<uint64_t> results(jobCount);
+        std::vector<JobHandle> handles;
+        handles.reserve(jobCount);
+        for (size_t job = 0; job < jobCount; job++) {
+            handles.push_back(tm.Submit([&results, job, iterations] { results[job] = Work(job, iterations); }));
+        }
+
+        uint64_t total = 0;
+        tm.Wait(tm.Submit([&] { total = Sum(results); }, handles));
+        return total;
+    }
+
+    uint64_t RunParallelFor(TaskManager& tm, size_t jobCount, uint32_t iterations) {
+        std::vector<uint64_t> results(jobCount);
+        tm.ParallelFor(jobCount, [&results, iterations](size_t begin, size_t end) {
+            for (size_t job = begin; job < end; job++) {
+                results[job] = Work(job, iterations);
+            }
+        });
+        return Sum(results);
+    }
+
+    // Median of the runs in milliseconds, the first run warms up the workers and is dropped
+    double Measure(const std::function<uint64_t()>& run, uint64_t expected, bool& mismatch) {
+        std::vector<double> times;
+        for (int i = 0; i <= RUNS; i++) {
+            const auto start = Clock::now();
+            const uint64_t result = run();
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (result != expected) mismatch = true;
+            if (i > 0) times.push_back(ms);
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    struct Workload {
+        const char* name;
+        size_t jobCount;
+        uint32_t iterations;
+    };
+}
+
+int main() {
+    TaskManager tm;
+    const int workerCount = static_cast<int>(tm.GetWorkerCount()) + 1;
+
+    const Workload workloads[] = {
+        { "tiny jobs",   16384, 200     },
+        { "small jobs",  4096,  5000    },
+        { "medium jobs", 256,   200000  },
+        { "large jobs",  32,    4000000 },
+    };
+
+    std::printf("%u workers + main thread, median of %d runs\n", tm.GetWorkerCount(), RUNS);
+    std::printf("%-12s %7s %12s %12s %12s %9s\n", "workload", "jobs", "Thread ms", "Submit ms", "ParFor ms", "speedup");
+
+    bool mismatch = false;
+    for (const auto& [name, jobCount, iterations] : workloads) {
+        std::vector<uint64_t> reference(jobCount);
+        for (size_t job = 0; job < jobCount; job++) {
+            reference[job] = Work(job, iterations);
+        }
+        const uint64_t expected = Sum(reference);
+
+        const double threadMs = Measure([&] { return RunThreads(jobCount, iterations, workerCount); }, expected, mismatch);
+        const double submitMs = Measure([&] { return RunSubmit(tm, jobCount, iterations); }, expected, mismatch);
+        const double forMs    = Measure([&] { return RunParallelFor(tm, jobCount, iterations); }, expected, mismatch);
+
+        std::printf("%-12s %7zu %12.3f %12.3f %12.3f %8.1fx\n",
+            name, jobCount, threadMs, submitMs, forMs, threadMs / std::min(submitMs, forMs));
+    }
+
+    if (mismatch) {
+        std::printf("Results don't match the serial reference!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+//
+// Created by pointerlost on 1/16/26.
+//
+#pragma once
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "Common/RealTypes.h"
+#include "Math/Math.h"
+
+// Synthetic meshes shared by the mesh tests and benchmarks
+
+namespace Real::tests {
+
+    struct TestMesh {
+        MeshBinaryHeader header;
+        std::vector<Vertex> vertices;
+        std::vector<PackedVertex> packed;
+        std::vector<uint32_t> indices;
+    };
+
+    // Height field grid, close enough to real meshes for the dictionary to find shared patterns
+    inline TestMesh MakeGrid(uint32_t size, float frequency, VertexFormat format) {
+        TestMesh mesh;
+        for (uint32_t z = 0; z <= size; z++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                const float fx = static_cast<float>(x), fz = static_cast<float>(z);
+                const float height = std::sin(fx * frequency) * std::cos(fz * frequency);
+                const glm::vec3 normal = glm::normalize(glm::vec3(-std::cos(fx * frequency), 1.0f, std::sin(fz * frequency)));
+                mesh.vertices.push_back({ glm::vec3(fx, height, fz), normal, glm::vec2(fx, fz) / static_cast<float>(size) });
+            }
+        }
+        for (uint32_t z = 0; z < size; z++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t i = z * (size + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), { i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2 });
+            }
+        }
+
+        mesh.header.m_VertexCount  = mesh.vertices.size();
+        mesh.header.m_IndexCount   = mesh.indices.size();
+        mesh.header.m_VertexFormat = format;
+        math::WriteAABB(math::ComputeAABB(mesh.vertices), mesh.header);
+        if (format == VertexFormat::COMPACT) {
+            mesh.packed = math::PackVertices(mesh.vertices, math::ToAABB(mesh.header));
+        }
+        return mesh;
+    }
+
+    // Same bytes as the compact payload, like the importer does
+    inline std::vector<uint8_t> Sample(const TestMesh& mesh) {
+        const size_t vertexBytes = mesh.packed.size() * sizeof(PackedVertex);
+        const size_t indexBytes  = mesh.indices.size() * sizeof(uint32_t);
+        std::vector<uint8_t> sample(vertexBytes + indexBytes);
+        std::memcpy(sample.data(), mesh.packed.data(), vertexBytes);
+        std::memcpy(sample.data() + vertexBytes, mesh.indices.data(), indexBytes);
+        return sample;
+    }
+}